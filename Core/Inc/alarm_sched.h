@@ -0,0 +1,56 @@
+
+/*
+ * alarm_sched.h  (STM32C0xx-ready)
+ *
+ * Alarm scheduler on top of the DS3231 alarms
+ * - Weekly events (h:m:s + weekday mask); the next-due one is always programmed into Alarm 1
+ * - Optional once-per-minute callback on Alarm 2
+ * - The MCU only learns about time through the INT/SQW falling edge (EXTI), no polling
+ */
+
+#ifndef __ALARM_SCHED_H__
+#define __ALARM_SCHED_H__
+
+#include "stdint.h"
+#include "ds3231_v3.h"
+
+#ifndef ALARMSCHED_MAX_EVENTS
+#define ALARMSCHED_MAX_EVENTS  8
+#endif
+
+/* Weekday mask: bit (day-1) for DS3231 day 1..7; 0 => every day */
+#define ALARMSCHED_EVERY_DAY   0x00
+
+typedef void (*AlarmSched_Callback)(uint8_t id);
+
+typedef struct {
+    uint8_t hours;    // 0-23
+    uint8_t minutes;  // 0-59
+    uint8_t seconds;  // 0-59
+    uint8_t days;     // weekday mask, ALARMSCHED_EVERY_DAY for daily
+    AlarmSched_Callback cb;
+} AlarmSched_Event;
+
+/* Returns event id (0..ALARMSCHED_MAX_EVENTS-1) or -1 if the table is full.
+ * Call AlarmSched_Start() (again) afterwards to reprogram the chip.
+ */
+int8_t AlarmSched_Add(const AlarmSched_Event *ev);
+void   AlarmSched_Remove(int8_t id);
+
+/* Alarm 2 every minute at :00 (NULL disables it) */
+void AlarmSched_SetMinuteCallback(AlarmSched_Callback cb);
+
+/* Reads the time once, programs the next-due event and enables the interrupts */
+HAL_StatusTypeDef AlarmSched_Start(void);
+
+/* Call from the INT/SQW EXTI callback (interrupt context) */
+void AlarmSched_OnIrq(void);
+
+/* 1 while an interrupt has been latched but not yet serviced by AlarmSched_Task() */
+uint8_t AlarmSched_Pending(void);
+
+/* Main-loop service: clears the flags, runs due callbacks, programs the next event.
+ * If the flags cannot be read the interrupt stays pending and the next call retries. */
+void AlarmSched_Task(void);
+
+#endif // __ALARM_SCHED_H__
@@ -0,0 +1,53 @@
+
+/*
+ * autobright.h  (STM32C0xx-ready)
+ *
+ * Automatic TA6932 brightness policy
+ * - Time-of-day curve (piecewise linear, minute resolution) from the DS3231 time
+ * - Optional thermal derating from the DS3231 temperature sensor
+ * - Evaluated once per minute from the caller's RTC snapshot: no I2C traffic of its own
+ */
+
+#ifndef __AUTOBRIGHT_H__
+#define __AUTOBRIGHT_H__
+
+#include "stdint.h"
+#include "ds3231_v3.h"
+
+/* Fade time used when the policy changes the level */
+#ifndef AUTOBRIGHT_FADE_MS
+#define AUTOBRIGHT_FADE_MS     800
+#endif
+
+/* Night / thermal floor level. 77 maps to exactly 16/256 duty (TA6932 step 1), and 255
+ * to step 8, so a steady level needs no dithering and sends no brightness commands */
+#ifndef AUTOBRIGHT_LEVEL_DIM
+#define AUTOBRIGHT_LEVEL_DIM   77
+#endif
+
+typedef struct {
+    uint16_t minute; // minute of day 0..1439
+    uint8_t  level;  // perceptual level 0..255 (see ta6932_fade.h)
+} AutoBright_Point;
+
+/* curve: points sorted by minute, wraps around midnight. NULL => built-in day/night curve */
+void AutoBright_Init(const AutoBright_Point *curve, uint8_t count);
+
+/* Thermal derating: above start_centi (centi-degrees C), subtract per_deg levels
+ * per degree, never below min_level. enable=0 disables it (and the snapshot then
+ * needs no temperature).
+ */
+void AutoBright_SetThermal(uint8_t enable, int16_t start_centi, uint8_t per_deg, uint8_t min_level);
+
+/* 1 if the next snapshot should include the temperature */
+uint8_t AutoBright_WantsTemperature(void);
+
+/* Feed the RTC snapshot. Re-evaluates only when the minute changed and only
+ * sends a brightness command (via TA6932_FadeTo) if the resulting level differs.
+ */
+void AutoBright_OnSnapshot(const DS3231_TimeTypeDef *time, int16_t centi);
+
+/* Last level chosen by the policy */
+uint8_t AutoBright_Level(void);
+
+#endif // __AUTOBRIGHT_H__
@@ -0,0 +1,42 @@
+
+/*
+ * boot.h  (STM32C0xx-ready)
+ *
+ * Boot timing trace
+ * - BOOT_Mark() stamps the end of each start-up stage in microseconds since HAL_Init()
+ * - Stamps survive the SysTick reload change done by SystemClock_Config()
+ * - BOOT_CaptureReset() reads the free-running SysTick started by Reset_Handler,
+ *   giving the reset-to-main cost in core cycles (reset clock, HSI48/4)
+ */
+
+#ifndef __BOOT_H__
+#define __BOOT_H__
+
+#include "stdint.h"
+#include "stm32c0xx_hal.h"
+
+#ifndef BOOT_MAX_STAGES
+#define BOOT_MAX_STAGES        10
+#endif
+
+typedef struct {
+    const char *name;   // static string
+    uint32_t    us;     // time since HAL_Init() at the end of the stage
+} BOOT_Stage;
+
+/* First statement of main(), before HAL_Init() reprograms SysTick */
+void     BOOT_CaptureReset(void);
+
+/* Core cycles from Reset_Handler to BOOT_CaptureReset() */
+uint32_t BOOT_ResetCycles(void);
+
+/* Record the end of a stage (call right after it) */
+void     BOOT_Mark(const char *name);
+
+/* Microseconds since HAL_Init() */
+uint32_t BOOT_Micros(void);
+
+/* Trace in call order; returns the number of stages */
+uint8_t  BOOT_GetTrace(const BOOT_Stage **trace);
+
+#endif // __BOOT_H__
@@ -0,0 +1,71 @@
+
+/*
+ * clk_gov.h  (STM32C0xx-ready)
+ *
+ * Clock governor: SYSCLK = HSI48 / HSIDIV, switched between a busy and an idle level
+ * - ClkGov_Boost() before bursty work (frame pushes, I2C snapshots)
+ * - ClkGov_Idle() when nothing is queued (right before WFI)
+ * - Every switch re-times SysTick (1 ms), FLASH->ACR (flash_acc), the SPI1
+ *   prescaler (ClkGov_SetSpiRate, 1.5 MHz by default) and I2C1 TIMINGR (100 kHz),
+ *   so bus speeds stay constant
+ * - A switch hook lets a peripheral that runs on its own (TA6932 autonomous refresh)
+ *   stop at a frame boundary before the switch and re-time itself after it
+ * - Refuses to switch while the I2C engine has a transfer in flight
+ */
+
+#ifndef __CLK_GOV_H__
+#define __CLK_GOV_H__
+
+#include "stdint.h"
+#include "stm32c0xx_hal.h"
+
+/* Levels = HSIDIV exponent; 3 MHz is the lowest that keeps SPI at 1.5 MHz
+   and I2C1 above the 2 MHz standard-mode minimum */
+typedef enum {
+    CLKGOV_48MHZ = 0,
+    CLKGOV_24MHZ,
+    CLKGOV_12MHZ,
+    CLKGOV_6MHZ,
+    CLKGOV_3MHZ,
+    CLKGOV_LEVELS
+} ClkGov_Level;
+
+#ifndef CLKGOV_IDLE_LEVEL
+#define CLKGOV_IDLE_LEVEL      CLKGOV_3MHZ
+#endif
+
+/* SPI1 rate cap; each level uses the fastest prescaler that does not exceed it */
+#ifndef CLKGOV_SPI_HZ
+#define CLKGOV_SPI_HZ          1500000UL
+#endif
+
+typedef struct {
+    uint32_t switches;      // completed transitions
+    uint32_t lastCycles;    // CPU cycles spent in the last transition
+    uint32_t worstCycles;   // worst transition so far
+    uint32_t refused;       // switch requests refused (bus busy)
+} ClkGov_Stats;
+
+/* Peripherals re-timed on every switch (either may be NULL) */
+void              ClkGov_Init(SPI_HandleTypeDef *hspi, I2C_HandleTypeDef *hi2c);
+
+/* before=1 right before the clock changes, before=0 once SystemCoreClock and the
+ * buses are re-timed. One hook (NULL = none). */
+typedef void (*ClkGov_SwitchHook)(uint8_t before);
+void              ClkGov_SetSwitchHook(ClkGov_SwitchHook hook);
+
+/* HAL_BUSY while an I2C transfer is in flight, HAL_ERROR on a bad level */
+HAL_StatusTypeDef ClkGov_SetLevel(ClkGov_Level level);
+ClkGov_Level      ClkGov_GetLevel(void);
+
+static inline HAL_StatusTypeDef ClkGov_Boost(void){ return ClkGov_SetLevel(CLKGOV_48MHZ); }
+static inline HAL_StatusTypeDef ClkGov_Idle(void) { return ClkGov_SetLevel(CLKGOV_IDLE_LEVEL); }
+
+/* SPI1 rate cap, applied now and on every switch */
+void              ClkGov_SetSpiRate(uint32_t max_hz);
+/* Actual SPI1 rate at the current level */
+uint32_t          ClkGov_SpiRate(void);
+
+const ClkGov_Stats *ClkGov_GetStats(void);
+
+#endif // __CLK_GOV_H__
@@ -0,0 +1,81 @@
+
+/*
+ * ds3231_cal.h  (STM32C0xx-ready)
+ *
+ * DS3231 aging-offset drift compensation
+ * - Counts 1 Hz SQW edges against a reference tick source over a long window
+ * - Converts the drift to an aging-register correction (1 LSB ~ 0.1 ppm) and writes it
+ * - Logs drift against temperature
+ * - Cached software clock on the reference ticks whose resync interval grows as
+ *   the measured residual drift shrinks (fewer I2C reads)
+ *
+ * All chip access goes through RtcCal_Port so a host RTC model with injected
+ * drift can stand in for the DS3231.
+ */
+
+#ifndef __DS3231_CAL_H__
+#define __DS3231_CAL_H__
+
+#include "stdint.h"
+#include "ds3231_v3.h"
+
+#ifndef RTCCAL_LOG_SIZE
+#define RTCCAL_LOG_SIZE        16
+#endif
+
+/* Aging LSB in parts per billion (datasheet: typ. 0.1 ppm at 25 C) */
+#define RTCCAL_PPB_PER_LSB     100
+
+typedef struct {
+    uint32_t (*refNow)(void);                          // reference tick counter (free running, must
+                                                       // keep counting in sleep while a window is open)
+    uint32_t refHz;                                    // reference tick frequency
+    /* NULL => DS3231 driver functions */
+    HAL_StatusTypeDef (*readAging)(int8_t *aging);
+    HAL_StatusTypeDef (*writeAging)(int8_t aging);     // must also apply it (CONV)
+    HAL_StatusTypeDef (*readTempCenti)(int16_t *centi);
+    HAL_StatusTypeDef (*enableSqw)(void);              // 1 Hz SQW on INT/SQW
+} RtcCal_Port;
+
+typedef struct {
+    int32_t drift_ppb;   // + => RTC slow against the reference
+    int16_t temp_centi;  // temperature at the end of the window
+    int8_t  aging;       // aging value in effect during the window
+} RtcCal_LogEntry;
+
+void    RtcCal_Init(const RtcCal_Port *port);
+
+/* Starts a measurement window of window_s seconds (switches INT/SQW to 1 Hz SQW) */
+HAL_StatusTypeDef RtcCal_Start(uint16_t window_s);
+uint8_t RtcCal_Active(void);
+
+/* Call on every SQW falling edge (interrupt context) */
+void    RtcCal_OnSqwEdge(void);
+
+/* Main-loop service. Returns 1 when a window just completed (log entry added,
+ * aging updated); the caller may then restore the alarm setup (AlarmSched_Start).
+ */
+uint8_t RtcCal_Task(void);
+
+int32_t RtcCal_LastDriftPpb(void);
+/* Expected drift left after the last correction */
+int32_t RtcCal_ResidualPpb(void);
+/* Log entries oldest first; returns the count */
+uint8_t RtcCal_GetLog(RtcCal_LogEntry *out, uint8_t max);
+
+/* Pure helpers (no chip access) */
+int32_t RtcCal_DriftPpb(uint64_t ref_elapsed, uint32_t seconds, uint32_t ref_hz);
+int8_t  RtcCal_NextAging(int8_t aging, int32_t drift_ppb);
+
+/* ===== Cached software clock =====
+ * Elapsed whole seconds are accumulated on every ClockNow/ClockNeedsSync/RtcCal_Task call,
+ * so refNow may wrap any number of times as long as those calls come more often than once
+ * per wrap period (2^32 / refHz).
+ */
+void     RtcCal_ClockSync(uint32_t epoch);          // after a DS3231 read
+uint32_t RtcCal_ClockNow(void);                     // epoch from reference ticks
+/* Seconds between resyncs that keep the clock within tolerance_ms of the RTC */
+uint32_t RtcCal_ResyncIntervalS(uint32_t tolerance_ms);
+uint8_t  RtcCal_ClockNeedsSync(uint32_t tolerance_ms);
+
+#endif // __DS3231_CAL_H__
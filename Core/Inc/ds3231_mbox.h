@@ -0,0 +1,66 @@
+
+/*
+ * ds3231_mbox.h  (STM32C0xx-ready)
+ *
+ * DS3231 time mailbox filled by hardware, no CPU involvement per second
+ * - INT/SQW runs as 1 Hz SQW into EXTI line 0 (event only, interrupt masked)
+ * - Each edge fires DMAMUX request generator 0; its DMA channel writes one
+ *   word into I2C1->CR2 (read, 19 bytes, AUTOEND, START)
+ * - A circular DMA channel on I2C1_RX stores the bytes in a RAM mailbox
+ *
+ * 19 bytes rather than 7: the DS3231 address pointer wraps from 0x12 to 0x00,
+ * so every autonomous read leaves it at the seconds register for the next one
+ * and no pointer write (which would need CPU help) is ever required.
+ *
+ * The I2C engine stays the bus owner: before it starts a transfer the generator
+ * is paused and any read in flight is allowed to finish; when its queue drains
+ * the pointer is re-primed by one full 19-byte read from 0x00 (that also
+ * refreshes the mailbox) and the generator is re-armed.
+ *
+ * INT/SQW cannot be both: while the mailbox runs, alarm interrupts
+ * (AlarmSched) and SQW calibration (RtcCal) are unavailable.
+ */
+
+#ifndef __DS3231_MBOX_H__
+#define __DS3231_MBOX_H__
+
+#include "stdint.h"
+#include "ds3231_v3.h"
+
+/* DMA1 has three channels; TA6932 autonomous refresh owns Channel3 */
+#ifndef RTCMBOX_CR2_DMA_CH
+#define RTCMBOX_CR2_DMA_CH     DMA1_Channel1
+#endif
+#ifndef RTCMBOX_RX_DMA_CH
+#define RTCMBOX_RX_DMA_CH      DMA1_Channel2
+#endif
+
+/* SQW edge that triggers the read. The seconds registers advance on the falling
+ * edge; the rising edge (500 ms later) reads a settled second.
+ */
+#ifndef RTCMBOX_EDGE_RISING
+#define RTCMBOX_EDGE_RISING    1
+#endif
+
+/* Bytes per autonomous read: 0x00..0x12, time + control/status + aging + temperature */
+#define RTCMBOX_LEN            (DS3231_REG_TEMP_LSB + 1)
+
+/* Switches INT/SQW to 1 Hz SQW, sets up the DMA chain and queues the priming
+ * read on the I2C engine (armed once it completes, from I2CEng_Task()).
+ */
+HAL_StatusTypeDef RtcMbox_Start(void);
+/* Disarms and restores the INT/SQW EXTI interrupt (falling edge). SQW stays on */
+void    RtcMbox_Stop(void);
+uint8_t RtcMbox_Active(void);
+/* 1 while the hardware refreshes the mailbox on its own */
+uint8_t RtcMbox_Armed(void);
+
+/* Consistent copy of the mailbox (waits out a read in flight).
+ * HAL_BUSY before the first read landed, HAL_ERROR if inactive or the last
+ * autonomous read was not acknowledged. centi may be NULL.
+ */
+HAL_StatusTypeDef RtcMbox_Get(DS3231_TimeTypeDef *time, int16_t *centi);
+/* Same, raw register bytes (BCD) */
+HAL_StatusTypeDef RtcMbox_GetRaw(uint8_t raw[RTCMBOX_LEN]);
+
+#endif // __DS3231_MBOX_H__
@@ -0,0 +1,40 @@
+
+/*
+ * ds3231_time.h  (STM32C0xx-ready)
+ *
+ * Calendar arithmetic for DS3231_TimeTypeDef
+ * - Integer-only, table-driven, O(1): no loops over years or months
+ * - Valid for 2000-01-01 .. 2099-12-31 (the DS3231 range; every 4th year is leap)
+ * - Day of week: 1 = Sunday .. 7 = Saturday
+ */
+
+#ifndef __DS3231_TIME_H__
+#define __DS3231_TIME_H__
+
+#include "stdint.h"
+#include "ds3231_v3.h"
+
+/* 2000-01-01T00:00:00 as Unix time */
+#define DS3231_EPOCH_2000      946684800UL
+
+/* Day-of-week values returned by DS3231_DayOfWeek() */
+#define DS3231_SUNDAY          1
+#define DS3231_SATURDAY        7
+
+uint8_t  DS3231_IsLeapYear(uint16_t year);
+uint8_t  DS3231_DaysInMonth(uint16_t year, uint8_t month);
+
+/* Days since 2000-01-01 (0 for a month outside 1..12 or date 0) */
+uint16_t DS3231_DaysSince2000(uint16_t year, uint8_t month, uint8_t date);
+uint8_t  DS3231_DayOfWeek(uint16_t year, uint8_t month, uint8_t date);
+
+/* Broken-down time <-> Unix seconds (t->day is ignored on input, computed on output) */
+uint32_t DS3231_ToEpoch(const DS3231_TimeTypeDef *t);
+void     DS3231_FromEpoch(uint32_t epoch, DS3231_TimeTypeDef *t);
+
+/* t += seconds (may be negative) */
+void     DS3231_AddSeconds(DS3231_TimeTypeDef *t, int32_t seconds);
+/* a - b in seconds */
+int32_t  DS3231_DiffSeconds(const DS3231_TimeTypeDef *a, const DS3231_TimeTypeDef *b);
+
+#endif // __DS3231_TIME_H__
@@ -12,8 +12,13 @@
 
 #include "stdint.h"
 #include "stm32c0xx_hal.h" // STM32C0xx family
+#include "i2c_engine.h"
 
 #define DS3231_I2C_ADDR        (0x68 << 1) // HAL expects 8-bit address
+/* Per-transaction deadline (19 bytes at 100 kHz take ~2 ms) */
+#ifndef DS3231_I2C_TIMEOUT_MS
+#define DS3231_I2C_TIMEOUT_MS  10
+#endif
 #define DS3231_REG_SECONDS     0x00
 #define DS3231_REG_MINUTES     0x01
 #define DS3231_REG_HOURS       0x02
@@ -21,8 +26,11 @@
 #define DS3231_REG_DATE        0x04
 #define DS3231_REG_MONTH       0x05
 #define DS3231_REG_YEAR        0x06
+#define DS3231_REG_ALARM1      0x07 // 0x07..0x0A: sec, min, hour, day/date
+#define DS3231_REG_ALARM2      0x0B // 0x0B..0x0D: min, hour, day/date
 #define DS3231_REG_CONTROL     0x0E
 #define DS3231_REG_STATUS      0x0F
+#define DS3231_REG_AGING       0x10 // signed, 1 LSB ~ 0.1 ppm; positive => slower
 #define DS3231_REG_TEMP_MSB    0x11
 #define DS3231_REG_TEMP_LSB    0x12
 
@@ -30,38 +38,111 @@
 #define DS3231_STATUS_OSF      (1u << 7)
 /* CONTROL bit7: EOSC (Enable Oscillator). 0 => run, 1 => stop */
 #define DS3231_CONTROL_EOSC    (1u << 7)
+/* CONTROL bit5: CONV. 1 => start a temperature conversion (also applies a new aging offset) */
+#define DS3231_CONTROL_CONV    (1u << 5)
 /* CONTROL bit2: INTCN. 0 => SQW output, 1 => interrupt */
 #define DS3231_CONTROL_INTCN   (1u << 2)
 /* CONTROL bits3..4: RS rate select. 00=>1Hz, 01=>1.024kHz, 10=>4.096kHz, 11=>8.192kHz */
 #define DS3231_CONTROL_RS_MASK ((1u << 3) | (1u << 4))
+/* CONTROL bit0/bit1: A1IE/A2IE (alarm drives INT/SQW low when INTCN=1) */
+#define DS3231_CONTROL_A1IE    (1u << 0)
+#define DS3231_CONTROL_A2IE    (1u << 1)
+/* STATUS bit0/bit1: A1F/A2F alarm flags (write 0 to clear) */
+#define DS3231_STATUS_A1F      (1u << 0)
+#define DS3231_STATUS_A2F      (1u << 1)
+
+/* Alarm register bits */
+#define DS3231_ALARM_MASK_BIT  (1u << 7) // AxMy: 1 => field ignored
+#define DS3231_ALARM_DYDT      (1u << 6) // 1 => day-of-week, 0 => date
+
+/* Alarm selectors for Enable/Disable/Check (same bit order as A1IE/A2IE, A1F/A2F) */
+#define DS3231_ALARM_1         (1u << 0)
+#define DS3231_ALARM_2         (1u << 1)
+
+/* INT/SQW pin on the MCU (open-drain, active low) */
+#ifndef DS3231_INT_PORT
+#define DS3231_INT_PORT        GPIOA
+#endif
+#ifndef DS3231_INT_PIN
+#define DS3231_INT_PIN         GPIO_PIN_0
+#endif
 
 typedef struct {
     uint8_t seconds; // 0-59
     uint8_t minutes; // 0-59
     uint8_t hours;   // 0-23
-    uint8_t day;     // 1-7
+    uint8_t day;     // 1-7 (1 = Sunday), derived from the date by Get/SetTime
     uint8_t date;    // 1-31
     uint8_t month;   // 1-12
     uint16_t year;   // e.g., 2025
 } DS3231_TimeTypeDef;
 
-/* Init with HAL I2C handle */
+/* Alarm 1 match modes (datasheet table 2) */
+typedef enum {
+    DS3231_A1_EVERY_SECOND = 0, // once per second
+    DS3231_A1_MATCH_S,          // seconds match
+    DS3231_A1_MATCH_MS,         // minutes + seconds match
+    DS3231_A1_MATCH_HMS,        // hours + minutes + seconds match
+    DS3231_A1_MATCH_DATE_HMS,   // date + hours + minutes + seconds match
+    DS3231_A1_MATCH_DAY_HMS     // day-of-week + hours + minutes + seconds match
+} DS3231_Alarm1Mode;
+
+/* Alarm 2 match modes (no seconds register: fires at :00) */
+typedef enum {
+    DS3231_A2_EVERY_MINUTE = 0, // once per minute
+    DS3231_A2_MATCH_M,          // minutes match
+    DS3231_A2_MATCH_HM,         // hours + minutes match
+    DS3231_A2_MATCH_DATE_HM,    // date + hours + minutes match
+    DS3231_A2_MATCH_DAY_HM      // day-of-week + hours + minutes match
+} DS3231_Alarm2Mode;
+
+typedef struct {
+    uint8_t seconds; // 0-59 (ignored by Alarm 2)
+    uint8_t minutes; // 0-59
+    uint8_t hours;   // 0-23
+    uint8_t dayDate; // 1-7 (DAY modes) or 1-31 (DATE modes)
+} DS3231_AlarmTypeDef;
+
+typedef void (*DS3231_DoneCallback)(HAL_StatusTypeDef status);
+
+/* Init with HAL I2C handle (binds the I2C engine) */
 void DS3231_Init(I2C_HandleTypeDef *hi2c);
 
 /* Basic time I/O */
 HAL_StatusTypeDef DS3231_SetTime(DS3231_TimeTypeDef *time);
 HAL_StatusTypeDef DS3231_GetTime(DS3231_TimeTypeDef *time);
+/* Registers 0x00..0x06 as read (BCD, no conversion), e.g. for TA6932_RenderClockBCD() */
+HAL_StatusTypeDef DS3231_GetTimeRaw(uint8_t raw[7]);
+/* Non-blocking: *time is filled, then cb runs from I2CEng_Task(). HAL_BUSY if one is pending */
+HAL_StatusTypeDef DS3231_GetTimeAsync(DS3231_TimeTypeDef *time, DS3231_DoneCallback cb);
 
 /* SQW control */
 HAL_StatusTypeDef DS3231_Enable1HzSQW(void);
 HAL_StatusTypeDef DS3231_DisableSQW(void);
 
-/* Temperature */
+/* Temperature (integer, centi-degrees C: 2575 => 25.75 C, resolution 0.25 C) */
+HAL_StatusTypeDef DS3231_ReadTemperatureCenti(int16_t *centi);
+int16_t DS3231_TempRawToCenti(uint8_t msb, uint8_t lsb);
+
+/* Float variant is opt-in: it pulls the soft-float library into the image */
+#ifndef DS3231_USE_FLOAT_TEMP
+#define DS3231_USE_FLOAT_TEMP  0
+#endif
+#if DS3231_USE_FLOAT_TEMP
 HAL_StatusTypeDef DS3231_ReadTemperature(float *temperature);
+#endif
+
+/* Snapshot: time + temperature in one burst read (0x00..0x12).
+ * centi may be NULL (then only the 7 time registers are read).
+ * One I2C transaction instead of two.
+ */
+HAL_StatusTypeDef DS3231_GetTimeTemp(DS3231_TimeTypeDef *time, int16_t *centi);
 
 /* BCD helpers */
 uint8_t DS3231_BCD2BIN(uint8_t val);
 uint8_t DS3231_BIN2BCD(uint8_t val);
+/* Registers 0x00..0x06 (BCD) -> time; day is derived from the date */
+void DS3231_DecodeTime(const uint8_t *raw, DS3231_TimeTypeDef *time);
 
 /* NEW in v3: direct register access */
 HAL_StatusTypeDef DS3231_ReadControl(uint8_t *val);
@@ -69,10 +150,28 @@ HAL_StatusTypeDef DS3231_WriteControl(uint8_t val);
 HAL_StatusTypeDef DS3231_ReadStatus(uint8_t *val);
 HAL_StatusTypeDef DS3231_WriteStatus(uint8_t val);
 
+/* Alarms */
+HAL_StatusTypeDef DS3231_SetAlarm1(const DS3231_AlarmTypeDef *alarm, DS3231_Alarm1Mode mode);
+HAL_StatusTypeDef DS3231_SetAlarm2(const DS3231_AlarmTypeDef *alarm, DS3231_Alarm2Mode mode);
+/* alarms: DS3231_ALARM_1 | DS3231_ALARM_2. Enable also sets INTCN (SQW off) */
+HAL_StatusTypeDef DS3231_EnableAlarmInt(uint8_t alarms);
+HAL_StatusTypeDef DS3231_DisableAlarmInt(uint8_t alarms);
+/* Reads A1F/A2F into *fired and clears the ones that were set (releases INT/SQW) */
+HAL_StatusTypeDef DS3231_CheckAlarms(uint8_t *fired);
+
+/* Aging offset (crystal trim). Takes effect at the next temperature conversion */
+HAL_StatusTypeDef DS3231_ReadAging(int8_t *aging);
+HAL_StatusTypeDef DS3231_WriteAging(int8_t aging);
+HAL_StatusTypeDef DS3231_StartConversion(void);
+
 /* NEW in v3: one-shot initializer
  * If OSF=1 (time invalid), this writes default time/date, enables SQW@1Hz, clears OSF.
+ * If the kept time is used instead, the DY register is rewritten when it does not match the
+ * weekday derived from the date (1 = Sunday), so Alarm 1 DAY matching uses the same convention.
  * Returns HAL_OK if ready to use afterwards.
  */
 HAL_StatusTypeDef DS3231_EnsureInitialized(const DS3231_TimeTypeDef *default_time);
+/* Same as above without blocking: runs on the I2C engine, cb(status) when done */
+HAL_StatusTypeDef DS3231_EnsureInitializedAsync(const DS3231_TimeTypeDef *default_time, DS3231_DoneCallback cb);
 
 #endif // __DS3231_V3_H__
@@ -0,0 +1,52 @@
+
+/*
+ * flash_acc.h  (STM32C0xx-ready)
+ *
+ * Flash accelerator profiles (FLASH->ACR: LATENCY, PRFTEN, ICEN)
+ * - FlashAcc_ForClock() returns the fastest safe setting for an HCLK:
+ *     <= 24 MHz: 0 WS, cache on, prefetch off (no wait state left to hide)
+ *     <= 48 MHz: 1 WS, cache on, prefetch on
+ * - HAL_Init() applies PREFETCH_ENABLE / INSTRUCTION_CACHE_ENABLE from
+ *   stm32c0xx_hal_conf.h; FlashAcc_ApplyForClock() after every clock change
+ *   replaces them with the profile above
+ * - FlashAcc_Bench() times a driver workload under any profile
+ */
+
+#ifndef __FLASH_ACC_H__
+#define __FLASH_ACC_H__
+
+#include "stdint.h"
+#include "stm32c0xx_hal.h"
+
+#define FLASHACC_0WS_MAX_HZ    24000000UL
+
+typedef struct {
+    uint32_t latency;   // FLASH_LATENCY_0 / FLASH_LATENCY_1
+    uint8_t  prefetch;  // PRFTEN
+    uint8_t  icache;    // ICEN
+} FlashAcc_Profile;
+
+typedef enum {
+    FLASHACC_WL_RENDER = 0,  // TA6932 temperature + digit rendering (overwrites the back buffer)
+    FLASHACC_WL_CALENDAR,    // DS3231_FromEpoch()
+    FLASHACC_WL_COPY,        // 64-byte copy from a flash table (data reads)
+    FLASHACC_WL_COUNT
+} FlashAcc_Workload;
+
+/* Optimal profile for a given HCLK */
+FlashAcc_Profile  FlashAcc_ForClock(uint32_t hclk_hz);
+
+/* HAL_ERROR if p->latency is too low for hclk_hz; latency is read back before returning */
+HAL_StatusTypeDef FlashAcc_Apply(const FlashAcc_Profile *p, uint32_t hclk_hz);
+
+/* Apply FlashAcc_ForClock(hclk_hz) */
+HAL_StatusTypeDef FlashAcc_ApplyForClock(uint32_t hclk_hz);
+
+/* Current ACR settings */
+void              FlashAcc_Get(FlashAcc_Profile *p);
+
+/* Mean cycles per iteration of a workload under p (the previous profile is restored);
+   0 if p is not valid at the current HCLK */
+uint32_t          FlashAcc_Bench(const FlashAcc_Profile *p, FlashAcc_Workload w, uint16_t iters);
+
+#endif // __FLASH_ACC_H__
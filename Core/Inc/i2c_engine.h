@@ -0,0 +1,114 @@
+
+/*
+ * i2c_engine.h  (STM32C0xx-ready)
+ *
+ * Interrupt-driven I2C transaction engine
+ * - Request queue of register (Mem) reads/writes, one transaction on the bus at a time
+ * - Per-transaction deadline in ms; on expiry the bus is recovered
+ *   (peripheral de-init, 9 SCL clocks + STOP by GPIO, re-init)
+ * - Completion callbacks run from I2CEng_Task() (main-loop context)
+ * - Blocking helper with a bounded, measured worst case
+ * - Per-device health: NACK/ARLO/BERR/timeout/retry counters, exponential
+ *   backoff after consecutive failures (a missing device stops using the bus)
+ */
+
+#ifndef __I2C_ENGINE_H__
+#define __I2C_ENGINE_H__
+
+#include "stdint.h"
+#include "stm32c0xx_hal.h"
+
+#ifndef I2CENG_QUEUE_LEN
+#define I2CENG_QUEUE_LEN       4
+#endif
+
+/* Bus recovery pins (I2C1 on PB6/PB7, see HAL_I2C_MspInit) */
+#ifndef I2CENG_SCL_PORT
+#define I2CENG_SCL_PORT        GPIOB
+#define I2CENG_SCL_PIN         GPIO_PIN_6
+#define I2CENG_SDA_PORT        GPIOB
+#define I2CENG_SDA_PIN         GPIO_PIN_7
+#endif
+
+/* Devices tracked by the health layer */
+#ifndef I2CENG_MAX_DEVICES
+#define I2CENG_MAX_DEVICES     4
+#endif
+/* Extra attempts after ARLO/BERR/timeout (a NACK is not retried) */
+#ifndef I2CENG_RETRIES
+#define I2CENG_RETRIES         1
+#endif
+/* Backoff after n consecutive failures: BASE << (n-1), capped at MAX */
+#ifndef I2CENG_BACKOFF_BASE_MS
+#define I2CENG_BACKOFF_BASE_MS 100
+#endif
+#ifndef I2CENG_BACKOFF_MAX_MS
+#define I2CENG_BACKOFF_MAX_MS  60000
+#endif
+
+#define I2CENG_READ            0
+#define I2CENG_WRITE           1
+
+typedef void (*I2CEng_Callback)(HAL_StatusTypeDef status, void *ctx);
+/* Bus ownership: acquire=1 before the first transfer after idle, acquire=0 once
+ * the queue has drained (after the last callback). Main-loop context; the hook
+ * may submit new requests.
+ */
+typedef void (*I2CEng_BusHook)(uint8_t acquire);
+
+typedef struct {
+    uint16_t dev;         // 8-bit address (HAL convention)
+    uint8_t  reg;         // register address (8-bit)
+    uint8_t  dir;         // I2CENG_READ / I2CENG_WRITE
+    uint8_t *buf;         // must stay valid until completion
+    uint16_t len;
+    uint16_t timeout_ms;  // deadline from the moment the transfer starts on the bus
+    I2CEng_Callback cb;   // may be NULL
+    void    *ctx;
+} I2CEng_Req;
+
+typedef struct {
+    uint16_t dev;         // 0 => unused slot
+    uint32_t ok;
+    uint32_t nack;        // address or data not acknowledged
+    uint32_t arlo;        // arbitration lost
+    uint32_t berr;        // bus error / overrun
+    uint32_t timeout;     // deadline expired (bus recovered)
+    uint32_t retry;
+    uint32_t skipped;     // rejected while backing off
+    uint8_t  fails;       // consecutive failed transactions
+    uint32_t holdUntil;   // HAL tick until which requests are rejected
+} I2CEng_Health;
+
+/* Binds the engine to a HAL handle (idempotent for the same handle) */
+void I2CEng_Init(I2C_HandleTypeDef *hi2c);
+
+/* Queues a request. HAL_BUSY if the queue is full or the device is backing off */
+HAL_StatusTypeDef I2CEng_Submit(const I2CEng_Req *req);
+
+/* Lets a bus user outside the engine (e.g. an autonomous DMA reader) step aside. NULL => none */
+void I2CEng_SetBusHook(I2CEng_BusHook hook);
+
+/* Starts queued transfers, enforces deadlines, dispatches callbacks */
+void I2CEng_Task(void);
+
+/* 1 while a transfer is running or queued */
+uint8_t I2CEng_Busy(void);
+
+/* Submit + wait. Blocks at most for the deadlines of the transfers ahead of it,
+ * this one, and one bus recovery each.
+ */
+HAL_StatusTypeDef I2CEng_Transfer(const I2CEng_Req *req);
+
+/* Worst blocking time seen in I2CEng_Transfer(), in CPU cycles (see prof.h) */
+uint32_t I2CEng_WorstBlockCycles(void);
+
+/* Health of one device (8-bit address); NULL if never seen */
+const I2CEng_Health *I2CEng_GetHealth(uint16_t dev);
+/* Drops the backoff of a device (e.g. after it was plugged back in) */
+void I2CEng_ResetBackoff(uint16_t dev);
+
+/* Frees a stuck bus: peripheral reset + 9 SCL clocks + STOP */
+void I2CEng_Recover(void);
+
+#endif // __I2C_ENGINE_H__
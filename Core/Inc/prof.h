@@ -0,0 +1,44 @@
+
+/*
+ * prof.h  (STM32C0xx-ready)
+ *
+ * Cycle profiling for Cortex-M0+ (no DWT CYCCNT on this core)
+ * - Cycle stamps built from HAL tick + SysTick->VAL (SysTick runs from HCLK)
+ * - Resolution: 1 CPU cycle, range: ~89 s at 48 MHz before 32-bit wrap
+ */
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#include "stdint.h"
+#include "stm32c0xx_hal.h"
+
+/* Free-running cycle stamp */
+uint32_t PROF_Stamp(void);
+
+/* Cycles elapsed since a stamp */
+uint32_t PROF_Cycles(uint32_t start);
+
+/* Fixed cost of a Stamp()+Cycles() pair; subtract it from short measurements */
+uint32_t PROF_Overhead(void);
+
+/* ===== Telemetry counters =====
+ * Modules register pointers to their 32-bit counters once; a debugger, shell or
+ * log task reads them all through PROF_GetCounter() without knowing the modules.
+ */
+#ifndef PROF_MAX_COUNTERS
+#define PROF_MAX_COUNTERS      16
+#endif
+
+typedef struct {
+    const char *name;                 // static string, e.g. "i2c.nack"
+    const volatile uint32_t *value;
+} PROF_Counter;
+
+/* Returns 0 if the table is full */
+uint8_t PROF_Register(const char *name, const volatile uint32_t *value);
+uint8_t PROF_CounterCount(void);
+/* 0 if index is out of range */
+uint8_t PROF_GetCounter(uint8_t index, const char **name, uint32_t *value);
+
+#endif // __PROF_H__
@@ -52,6 +52,8 @@ void SVC_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 /* USER CODE BEGIN EFP */
+void EXTI0_1_IRQHandler(void);
+void I2C1_IRQHandler(void);
 
 /* USER CODE END EFP */
 
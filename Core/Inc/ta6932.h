@@ -8,6 +8,7 @@
 // >>> Controller: STM32C011F6P6 (STM32C0 series) <<<
 #include "stm32c0xx_hal.h"
 #include <stdint.h>
+#include "ta6932_font.h"   // خريطة توصيل المقاطع → جداول الأحرف
 
 // --- STB pin (عدّلها حسب لوحتك إن لزم) ---
 #ifndef TA_STB_PORT
@@ -17,6 +18,53 @@
 #define TA_STB_PIN   GPIO_PIN_4
 #endif
 
+// --- تنفيذ المسار الساخن من RAM (قسم .RamFunc يُنسخ مع .data عند الإقلاع) ---
+#ifndef TA6932_USE_RAMFUNC
+#define TA6932_USE_RAMFUNC  1
+#endif
+#if TA6932_USE_RAMFUNC
+#define TA_RAMFUNC  __attribute__((section(".RamFunc"), noinline))
+#else
+#define TA_RAMFUNC
+#endif
+// مساعدات تستدعيها دوال RAM: inline إجباري حتى في Debug (-O0) وإلا تُولَّد كدالة في الفلاش
+#define TA_INLINE  inline __attribute__((always_inline))
+
+// --- STB بالعتاد: PA4 = SPI1_NSS (AF0) بدل GPIO ---
+// NSS منخفض طالما SPE=1 (SSOE=1, NSSP=0)، فتُرسل حزمة (عنوان + 16 بايت) دون أي تدخل
+// برمجي على الطرف. وضع NSSP (نبضة بين كل بايت) لا يصلح: ينهي الأمر بعد أول بايت.
+#ifndef TA6932_HW_STB
+#define TA6932_HW_STB  0
+#endif
+
+// --- حدود توقيت STB (نموذج المضيف، عائلة TM16xx/TA69xx) ---
+#ifndef TA6932_PW_STB_NS
+#define TA6932_PW_STB_NS    1000u   // أقل عرض لـ STB مرتفع بين أمرين
+#endif
+#ifndef TA6932_T_CLK_STB_NS
+#define TA6932_T_CLK_STB_NS 1000u   // من آخر حافة CLK إلى صعود STB
+#endif
+
+// --- التحديث الذاتي (TA6932_AutoStart) ---
+#ifndef TA6932_AUTO_DMA_CH
+#define TA6932_AUTO_DMA_CH      DMA1_Channel3
+#endif
+#ifndef TA6932_AUTO_PERIOD_US
+#define TA6932_AUTO_PERIOD_US   20000u  // 50 إطار/ث
+#endif
+#ifndef TA6932_AUTO_GUARD_US
+#define TA6932_AUTO_GUARD_US    20u     // لا إيقاف قرب نهاية الدورة (بداية إطار جديد)
+#endif
+
+// حلقات انتظار حول صعود STB (قبله: t_CLK_STB، بعده: PW_STB)
+// TA_STB_LOOP_CYCLES = أقل كلفة للحلقة (أسرع بناء)؛ تستخدمه دالة الفحص
+#ifndef TA_STB_GAP_LOOPS
+#define TA_STB_GAP_LOOPS    12
+#endif
+#ifndef TA_STB_LOOP_CYCLES
+#define TA_STB_LOOP_CYCLES  4u
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -24,6 +72,7 @@ extern "C" {
 // ===== Core API =====
 void TA6932_Init(void);
 void TA6932_WriteAll(void);
+void TA6932_WriteDirty(uint16_t mask);  // bit n = خانة منطقية n؛ يرسل أقصر مدى شبكات يغطيها
 void TA6932_TestPattern(void);
 void TA6932_CounterDemo(void);
 
@@ -34,24 +83,142 @@ void TA6932_putChar(uint8_t addr, char ch, int dp); // محرف ASCII عبر ا
 void TA6932_Clear(void);                            // مسح وإرسال
 
 // تعبئة سريعة لكل البافر
-void TA6932_loadBuffer(const uint8_t *src);         // نسخ 16 بايت إلى البافر
-void TA6932_loadBuffer16(uint8_t b0,uint8_t b1,uint8_t b2,uint8_t b3,
-                         uint8_t b4,uint8_t b5,uint8_t b6,uint8_t b7,
-                         uint8_t b8,uint8_t b9,uint8_t b10,uint8_t b11,
-                         uint8_t b12,uint8_t b13,uint8_t b14,uint8_t b15);
+void TA6932_loadBuffer(const uint8_t *src);         // نسخ 16 بايت إلى البافر (كلمات إن كان محاذى على 4)
+void TA6932_loadWords(uint32_t w0, uint32_t w1, uint32_t w2, uint32_t w3);  // الكلمة k = الخانات 4k..4k+3
+// تجميع 4 خانات في كلمة (little-endian: b0 = الخانة الأولى)؛ يُطوى وقت الترجمة للثوابت
+#define TA_W(b0,b1,b2,b3)  ((uint32_t)(uint8_t)(b0)         | ((uint32_t)(uint8_t)(b1) << 8) | \
+                            ((uint32_t)(uint8_t)(b2) << 16) | ((uint32_t)(uint8_t)(b3) << 24))
+// الواجهة القديمة ذات الـ16 وسيطاً → 4 كلمات في السجلات (بلا تسريب للمكدس على M0+)
+#define TA6932_loadBuffer16(b0,b1,b2,b3,b4,b5,b6,b7,b8,b9,b10,b11,b12,b13,b14,b15) \
+  TA6932_loadWords(TA_W(b0,b1,b2,b3), TA_W(b4,b5,b6,b7), TA_W(b8,b9,b10,b11), TA_W(b12,b13,b14,b15))
+
+// ===== طبقات البافر: كل طبقة 16 بايت = 4 كلمات محاذاة (البايت n = خانة منطقية n) =====
+// الإطار المرسل = (BASE | OVERLAY) & ~(HIDE | الوميض)، يُركَّب كلمة كلمة عند الإرسال.
+// digits: bit n = خانة n، segs: المقاطع. مثال: كل نقاط dp = LayerOr(BASE, 0xFFFF, 0x80).
+// اختياري (افتراضياً 0): يضيف 32 بايت RAM ونسخة تركيب عند كل إرسال، ويلغي zero-copy للتحديث الذاتي.
+// بدونه OVERLAY/HIDE غير موجودتين (LayerWords يرجع NULL وعملياتها لا تفعل شيئاً)؛ BASE تعمل دائماً.
+#ifndef TA6932_USE_LAYERS
+#define TA6932_USE_LAYERS  0
+#endif
+typedef enum {
+  TA6932_LAYER_BASE = 0,   // ما ترسمه putDigit/putChar/... (g_buf)
+  TA6932_LAYER_OVERLAY,    // مؤشر، علامات dp (OR)
+  TA6932_LAYER_HIDE        // إطفاء منطقة دون مسح الأساس (ANDN)
+} TA6932_Layer;
+uint32_t *TA6932_LayerWords(TA6932_Layer layer);   // 4 كلمات؛ NULL إن لم تكن الطبقة مفعّلة
+void TA6932_LayerOr  (TA6932_Layer layer, uint16_t digits, uint8_t segs);  // إضاءة
+void TA6932_LayerAndn(TA6932_Layer layer, uint16_t digits, uint8_t segs);  // إطفاء
+void TA6932_LayerXor (TA6932_Layer layer, uint16_t digits, uint8_t segs);  // عكس
+void TA6932_LayerFill(TA6932_Layer layer, uint8_t segs);                   // كل الخانات = segs
 
 // ===== كتابة خانة واحدة مباشرة (Fixed Address) – الواجهات القديمة =====
 void TA6932_WriteOneRaw(uint8_t addr, uint8_t value);
 void TA6932_putDigitOne(uint8_t addr, int d, int dp);
 void TA6932_putCharOne(uint8_t addr, char ch, int dp);
 
+// ===== عرض الحرارة (أعداد صحيحة فقط، بدون float) =====
+// centi = درجة مئوية × 100 (مثل DS3231_ReadTemperatureCenti). يكتب 4 خانات في البافر:
+// "23.5C" / "-5.2C" / "-12C" / "105C"؛ خارج المدى يُقصّ إلى -99C .. 163C
+void TA6932_putTemperature(uint8_t addr, int16_t centi);
+
+// ===== التخطيط المنطقي: الحقول على خانات منطقية 0..15 =====
+// كل دوال الرسم (putDigit/putBCD/RenderClockBCD...) تكتب خانات منطقية. نفس ترتيب TA6932_TestPattern:
+// كل عنوان يُعاد تعريفه وحده (-DTA6932_CLK_ADDR_HH=8 مثلاً)؛ الباقي يبقى على الافتراضي
+#ifndef TA6932_CLK_ADDR_HH
+#define TA6932_CLK_ADDR_HH    0x00  // HH (خانتان)
+#endif
+#ifndef TA6932_CLK_ADDR_MM
+#define TA6932_CLK_ADDR_MM    0x02  // MM
+#endif
+#ifndef TA6932_CLK_ADDR_SS
+#define TA6932_CLK_ADDR_SS    0x04  // SS
+#endif
+#ifndef TA6932_CLK_ADDR_YYYY
+#define TA6932_CLK_ADDR_YYYY  0x06  // "20" + YY
+#endif
+#ifndef TA6932_CLK_ADDR_MON
+#define TA6932_CLK_ADDR_MON   0x0A  // شهر
+#endif
+#ifndef TA6932_CLK_ADDR_DATE
+#define TA6932_CLK_ADDR_DATE  0x0C  // يوم الشهر
+#endif
+#ifndef TA6932_CLK_ADDR_COLON
+#define TA6932_CLK_ADDR_COLON 0x0E  // النقطتان (dp)
+#endif
+#ifndef TA6932_CLK_ADDR_WDAY
+#define TA6932_CLK_ADDR_WDAY  0x0F  // يوم الأسبوع
+#endif
+
+// ===== خريطة الخانات: منطقي → شبكة فعلية (GRID) على اللوحة =====
+// لوحة أعيد ترتيب خطوطها: عرّف TA6932_DIGIT_MAP بـ 16 رقماً (الشبكة الفعلية لكل خانة منطقية)، مثلاً
+//   #define TA6932_DIGIT_MAP  1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14
+// يُطبَّق مرة واحدة عند الإرسال (WriteAll) بنسخ مفكوك بعناوين ثابتة وقت الترجمة (بلا جدول).
+// بدون الماكرو (ومع TA6932_USE_BLINK=0 وTA6932_USE_LAYERS=0): البافر هو الإطار نفسه ولا أي نسخ.
+// مع التحديث الذاتي والخريطة/الوميض/الطبقات: WriteAll تنشر البافر إلى إطار الـ DMA (بلا SPI).
+
+// ===== عرض الوقت من سجلات DS3231 الخام (BCD) بلا أي تحويل =====
+// كل نصف بايت BCD = رقم واحد → بحث واحد في الفونت
+void TA6932_putBCD(uint8_t addr, uint8_t bcd, int dp);  // خانتان: العشرات في addr والآحاد في addr+1 (dp عليها)
+// raw = سجلات 0x00..0x06 كما تُقرأ. يقارن مع الكتلة السابقة ويرسم الحقول المتغيرة فقط
+// (بت dp في كل خانة يبقى كما هو). يرجع قناع الحقول المتغيرة (bit n = السجل n)، 0 = لا شيء.
+uint8_t TA6932_RenderClockBCD(const uint8_t *raw);
+void    TA6932_RenderClockReset(void);                  // الاستدعاء التالي يرسم كل الحقول
+
+// ===== مستوى الوميض (attributes) بجانب البافر =====
+// يُطبَّق عند الإرسال بقناع مقاطع لكل خانة؛ التطبيق لا يعيد الرسم للوميض أبداً.
+// مع الوميض (أو الخريطة) البافر منطقي منفصل عن إطار الإرسال.
+// اختياري (افتراضياً 0): البافر المنطقي يصبح منفصلاً عن إطار الإرسال (RAM + نسخة تركيب عند كل إرسال).
+#ifndef TA6932_USE_BLINK
+#define TA6932_USE_BLINK  0
+#endif
+#if TA6932_USE_BLINK
+// segs = المقاطع التي تُطفأ في نصف الدورة الثاني (0xFF كل الخانة، 0x80 النقطتان/dp فقط)؛
+// segs=0 أو period_ms<2 يلغي الوميض. phase_ms يزيح الطور (خانات بنفس الدورة والطور متزامنة).
+void     TA6932_SetBlink(uint8_t addr, uint8_t segs, uint16_t period_ms, uint16_t phase_ms);
+// tick الوميض من الحلقة الرئيسية: يرسل فقط الخانات التي تغيّر ظاهرها. يرجع قناعها.
+uint16_t TA6932_BlinkTask(void);
+uint8_t  TA6932_BlinkActive(void);   // 1 → يحتاج SysTick (لا تُوقفه في النوم)
+#else
+static inline uint16_t TA6932_BlinkTask(void)   { return 0; }
+static inline uint8_t  TA6932_BlinkActive(void) { return 0; }
+#endif
+
+// ===== التحديث الذاتي: TIM14 يولّد STB على PA4 والـ DMA يرسل g_buf كل دورة =====
+// بلا أي دورة معالج: التطبيق يكتب البافر فقط (putDigit/putRaw...) وWriteAll لا تفعل شيئاً.
+// zero-copy فقط بالإعداد الافتراضي (بلا TA6932_DIGIT_MAP، وUSE_BLINK=0 وUSE_LAYERS=0). تفعيل أيٍّ منها
+// يجعل WriteAll إلزامية بعد كل رسم (تركيب 16 بايت في إطار الـ DMA) مقابل الخريطة/الوميض/الطبقات.
+// أوامر السطوع/التشغيل تبقى متاحة: تُرسل بين إطارين (انتظار ≤ إطار واحد) ولا تؤخر الإطار التالي.
+// ClkGov_SetLevel يُنفَّذ بين إطارين أيضاً ويعيد ضبط TIM14؛ إن لم يعد الإطار يتسع في الدورة يتوقف
+// التحديث الذاتي. الـ fade لا يعمل dithering أثناءه (الدرجة الأقرب فقط). يعمل في Sleep.
+HAL_StatusTypeDef TA6932_AutoStart(uint16_t period_us);  // HAL_ERROR إذا كانت الدورة أقصر من الإطار
+void    TA6932_AutoStop(void);
+uint8_t TA6932_AutoActive(void);
+
+// ===== فحص توقيت STB (نموذج المضيف) =====
+typedef struct {
+  uint32_t stbHighNs;   // STB مرتفع بين أمرين
+  uint32_t clkStbNs;    // آخر حافة CLK → صعود STB
+} TA6932_StbTiming;
+// يحسب التوقيت الناتج عن معدل SCK وتردد المعالج؛ يرجع 1 إذا احترم الحدود أعلاه
+uint8_t TA6932_CheckStbTiming(uint32_t sck_hz, uint32_t cpu_hz, TA6932_StbTiming *t);
+
+// ===== قياس الأداء =====
+uint32_t TA6932_BenchRefresh(uint16_t n);  // متوسط دورات المعالج لكل (رسم + إرسال 16 خانة)
+uint16_t TA6932_RamFuncBytes(void);        // حجم كل دوال .RamFunc المنسوخة إلى RAM
+
 // ===== السطوع / التشغيل والإيقاف =====
 void TA6932_SetBrightness(uint8_t level); // 0..7 (وتشغيل العرض)
 void TA6932_DisplayOn(void);
 void TA6932_DisplayOff(void);
 
 // ===== تحكم بالفونت =====
+// الفونت const في الفلاش افتراضياً؛ TA6932_GLYPH_RAM=1 ينقله إلى RAM ويتيح setGlyph
+#ifndef TA6932_GLYPH_RAM
+#define TA6932_GLYPH_RAM  0
+#endif
+#if TA6932_GLYPH_RAM
 void TA6932_setGlyph(uint8_t ch, uint8_t pattern);  // ضبط/تغيير نمط محرف (bit7=dp يُضاف خارجياً)
+#endif
 
 // ===== Unified One-API (الجديدة) =====
 // ميّز القيمة كـ RAW بهذا الماكرو (لا يتعارض مع الأرقام/الأحرف)
@@ -0,0 +1,46 @@
+// TA6932 fade engine
+//Version:1.0
+//Date:19/10/2026
+
+#ifndef __TA6932_FADE_H
+#define __TA6932_FADE_H
+
+#include "ta6932.h"
+#include <stdint.h>
+
+// مدة الإطار بين تحديثات السطوع (dithering) بالميلي ثانية
+#ifndef TA6932_FADE_FRAME_MS
+#define TA6932_FADE_FRAME_MS  4
+#endif
+
+// 1 → المستوى الثابت بين درجتين يبقى dithering (أمر سطوع كل بضعة إطارات وSysTick دائم).
+// 0 (افتراضي) → في السكون الدرجة الأقرب، ولا أمر SPI ولا tick حتى التغيير التالي.
+#ifndef TA6932_FADE_DITHER_STEADY
+#define TA6932_FADE_DITHER_STEADY  0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*TA6932_FadeCallback)(void);
+
+// ===== Perceptual level (0..255, gamma 2.2) =====
+// 0 = إطفاء، وأي مستوى آخر لا يقل عن الدرجة 1. بين درجات العتاد الثمانية: dithering على مستوى
+// الإطار أثناء الـ fade، والدرجة الأقرب عند السكون وأثناء التحديث الذاتي (TA6932_AutoActive).
+void    TA6932_SetLevel(uint8_t level);   // فوري (يلغي أي fade جارٍ)
+uint8_t TA6932_GetLevel(void);
+
+// ===== Asynchronous fade =====
+// يبدأ تلاشياً من المستوى الحالي إلى level خلال duration_ms، ثم يستدعي cb (يمكن NULL).
+void    TA6932_FadeTo(uint8_t level, uint16_t duration_ms, TA6932_FadeCallback cb);
+uint8_t TA6932_FadeBusy(void);
+// 1 إذا كان FadeTask يحتاج SysTick (fade جارٍ، أو dithering ثابت مع TA6932_FADE_DITHER_STEADY)
+uint8_t TA6932_FadeNeedsTick(void);
+// تُستدعى من الحلقة الرئيسية؛ لا ترسل شيئاً إلا عند تغيّر الدرجة الفعلية.
+void    TA6932_FadeTask(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,52 @@
+// TA6932 field layout engine
+//Version:1.0
+//Date:19/10/2026
+
+#ifndef __TA6932_FIELD_H
+#define __TA6932_FIELD_H
+
+#include "ta6932.h"
+#include <stdint.h>
+
+// أقصى عدد حقول مسجّلة
+#ifndef TA6932_FIELD_MAX
+#define TA6932_FIELD_MAX  8
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// القيمة الحالية لمصدر الحقل (مثلاً BCD مضغوط من سجلات DS3231)
+typedef uint32_t (*TA6932_FieldSource)(void);
+// يرسم value في الخانات المنطقية first..first+count-1 (في البافر فقط)
+typedef void (*TA6932_FieldRender)(uint8_t first, uint8_t count, uint32_t value);
+
+typedef struct {
+  uint8_t  first;             // أول خانة منطقية
+  uint8_t  count;             // عدد الخانات
+  uint16_t period_ms;         // كل كم يُسأل المصدر (0 = كل استدعاء لـ FieldTask)
+  TA6932_FieldSource source;
+  TA6932_FieldRender render;  // NULL → TA6932_FieldRenderBCD
+} TA6932_Field;
+
+// يسجّل حقلاً (يُنسخ)؛ يرجع رقمه أو -1 إذا امتلأ السجل أو تجاوز المدى 16 خانة
+// أو إذا كان render = NULL و count > 8 (الراسم الافتراضي يحمل 8 أرقام BCD فقط)
+int8_t   TA6932_FieldAdd(const TA6932_Field *f);
+void     TA6932_FieldClear(void);                 // يحذف كل الحقول
+void     TA6932_FieldInvalidate(int8_t id);       // يُرسم في المرة القادمة حتى لو لم يتغير (-1 = الكل)
+
+// من الحلقة الرئيسية: يسأل الحقول المستحقة فقط، يعيد رسم ما تغيّر مصدره،
+// ويرسل خاناته فقط (TA6932_WriteDirty). يرجع قناع الخانات المرسلة (0 = لا شيء).
+uint16_t TA6932_FieldTask(void);
+// ms حتى أقرب حقل مستحق (0xFFFFFFFF إن لا حقول)، لضبط مدة النوم
+uint32_t TA6932_FieldNextDueMs(void);
+
+// راسم جاهز: value = أرقام BCD مضغوطة، أدنى نصف بايت = آخر خانة (0x1234 → "1234")
+// حتى 8 خانات؛ لا يغيّر dp الخانات
+void     TA6932_FieldRenderBCD(uint8_t first, uint8_t count, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,99 @@
+// TA6932 font: glyph tables generated from a compile-time segment wiring map
+//Version:1.0
+//Date:19/10/2026
+// - الأحرف معرّفة بأسماء المقاطع (a..g) لا بالبتات؛ خريطة التوصيل تحوّلها إلى بايتات وقت الترجمة
+// - لا أي كلفة وقت التشغيل: الجدول const في الفلاش
+
+#ifndef __TA6932_FONT_H
+#define __TA6932_FONT_H
+
+#include <stdint.h>
+
+//        a b c d e f g dp  → رقم البت الذي يقود المقطع
+#define TA6932_WIRING_STD    0,1,2,3,4,5,6,7   // الترتيب القياسي ('1' = 0x06)
+#define TA6932_WIRING_BOARD  2,0,5,4,3,1,6,7   // لوحة TA6932 الحالية ('1' = 0x21)
+
+// --- متغير اللوحة: سطر واحد (أو -DTA6932_WIRING=...) ---
+#ifndef TA6932_WIRING
+#define TA6932_WIRING  TA6932_WIRING_BOARD
+#endif
+
+#define TA__PICK(m, ...)            m(__VA_ARGS__)
+#define TA__A(a,b,c,d,e,f,g,p)      (1u << (a))
+#define TA__B(a,b,c,d,e,f,g,p)      (1u << (b))
+#define TA__C(a,b,c,d,e,f,g,p)      (1u << (c))
+#define TA__D(a,b,c,d,e,f,g,p)      (1u << (d))
+#define TA__E(a,b,c,d,e,f,g,p)      (1u << (e))
+#define TA__F(a,b,c,d,e,f,g,p)      (1u << (f))
+#define TA__G(a,b,c,d,e,f,g,p)      (1u << (g))
+#define TA__P(a,b,c,d,e,f,g,p)      (1u << (p))
+
+#define TA_SEG_A   TA__PICK(TA__A, TA6932_WIRING)
+#define TA_SEG_B   TA__PICK(TA__B, TA6932_WIRING)
+#define TA_SEG_C   TA__PICK(TA__C, TA6932_WIRING)
+#define TA_SEG_D   TA__PICK(TA__D, TA6932_WIRING)
+#define TA_SEG_E   TA__PICK(TA__E, TA6932_WIRING)
+#define TA_SEG_F   TA__PICK(TA__F, TA6932_WIRING)
+#define TA_SEG_G   TA__PICK(TA__G, TA6932_WIRING)
+#define TA_SEG_DP  TA__PICK(TA__P, TA6932_WIRING)
+
+// الخريطة يجب أن تكون تبديلاً للبتات 0..7 (كل مقطع على بت مختلف)
+_Static_assert((TA_SEG_A | TA_SEG_B | TA_SEG_C | TA_SEG_D |
+                TA_SEG_E | TA_SEG_F | TA_SEG_G | TA_SEG_DP) == 0xFFu,
+               "TA6932_WIRING: each segment needs its own bit 0..7");
+
+#define TA_GLYPH(a,b,c,d,e,f,g) ((uint8_t)(((a) ? TA_SEG_A : 0u) | ((b) ? TA_SEG_B : 0u) | \
+                                           ((c) ? TA_SEG_C : 0u) | ((d) ? TA_SEG_D : 0u) | \
+                                           ((e) ? TA_SEG_E : 0u) | ((f) ? TA_SEG_F : 0u) | \
+                                           ((g) ? TA_SEG_G : 0u)))
+
+//                          a b c d e f g
+#define TA_GLYPH_0  TA_GLYPH(1,1,1,1,1,1,0)
+#define TA_GLYPH_1  TA_GLYPH(0,1,1,0,0,0,0)
+#define TA_GLYPH_2  TA_GLYPH(1,1,0,1,1,0,1)
+#define TA_GLYPH_3  TA_GLYPH(1,1,1,1,0,0,1)
+#define TA_GLYPH_4  TA_GLYPH(0,1,1,0,0,1,1)
+#define TA_GLYPH_5  TA_GLYPH(1,0,1,1,0,1,1)
+#define TA_GLYPH_6  TA_GLYPH(1,0,1,1,1,1,1)
+#define TA_GLYPH_7  TA_GLYPH(1,1,1,0,0,0,0)
+#define TA_GLYPH_8  TA_GLYPH(1,1,1,1,1,1,1)
+#define TA_GLYPH_9  TA_GLYPH(1,1,1,1,0,1,1)
+
+// جدول ASCII كامل (128) بمُهيّئات مُعيَّنة؛ المحارف غير المعرّفة = فراغ
+// حروف تقريبية: بعضها يتشارك الشكل (K=X=H، V=W=U، Z=2، S=5)
+#define TA6932_FONT_ASCII {                                   \
+  ['0'] = TA_GLYPH_0, ['1'] = TA_GLYPH_1, ['2'] = TA_GLYPH_2,   \
+  ['3'] = TA_GLYPH_3, ['4'] = TA_GLYPH_4, ['5'] = TA_GLYPH_5,   \
+  ['6'] = TA_GLYPH_6, ['7'] = TA_GLYPH_7, ['8'] = TA_GLYPH_8,   \
+  ['9'] = TA_GLYPH_9,                                          \
+  ['-'] = TA_GLYPH(0,0,0,0,0,0,1),                              \
+  ['_'] = TA_GLYPH(0,0,0,1,0,0,0),                              \
+  ['A'] = TA_GLYPH(1,1,1,0,1,1,1), ['a'] = TA_GLYPH(1,1,1,0,1,1,1), \
+  ['b'] = TA_GLYPH(0,0,1,1,1,1,1),                              \
+  ['C'] = TA_GLYPH(1,0,0,1,1,1,0), ['c'] = TA_GLYPH(0,0,0,1,1,0,1), \
+  ['d'] = TA_GLYPH(0,1,1,1,1,0,1),                              \
+  ['E'] = TA_GLYPH(1,0,0,1,1,1,1),                              \
+  ['F'] = TA_GLYPH(1,0,0,0,1,1,1),                              \
+  ['G'] = TA_GLYPH(1,0,1,1,1,1,0),                              \
+  ['H'] = TA_GLYPH(0,1,1,0,1,1,1),                              \
+  ['I'] = TA_GLYPH(0,0,0,0,1,1,0),                              \
+  ['J'] = TA_GLYPH(0,1,1,1,1,0,0),                              \
+  ['K'] = TA_GLYPH(0,1,1,0,1,1,1),                              \
+  ['L'] = TA_GLYPH(0,0,0,1,1,1,0),                              \
+  ['M'] = TA_GLYPH(1,1,1,0,1,1,0),                              \
+  ['N'] = TA_GLYPH(1,1,1,0,1,1,0), ['n'] = TA_GLYPH(0,0,1,0,1,0,1), \
+  ['o'] = TA_GLYPH(0,0,1,1,1,0,1),                              \
+  ['P'] = TA_GLYPH(1,1,0,0,1,1,1),                              \
+  ['Q'] = TA_GLYPH(1,1,1,0,0,1,1),                              \
+  ['r'] = TA_GLYPH(0,0,0,0,1,0,1),                              \
+  ['S'] = TA_GLYPH(1,0,1,1,0,1,1),                              \
+  ['t'] = TA_GLYPH(0,0,0,1,1,1,1),                              \
+  ['U'] = TA_GLYPH(0,1,1,1,1,1,0),                              \
+  ['V'] = TA_GLYPH(0,1,1,1,1,1,0),                              \
+  ['W'] = TA_GLYPH(0,1,1,1,1,1,0),                              \
+  ['X'] = TA_GLYPH(0,1,1,0,1,1,1),                              \
+  ['Y'] = TA_GLYPH(0,1,1,1,0,1,1),                              \
+  ['Z'] = TA_GLYPH(1,1,0,1,1,0,1),                              \
+}
+
+#endif
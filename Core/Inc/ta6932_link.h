@@ -0,0 +1,56 @@
+// TA6932 SPI link rate (self-test sweep + persisted result)
+//Version:1.0
+//Date:19/10/2026
+
+#ifndef __TA6932_LINK_H
+#define __TA6932_LINK_H
+
+#include "ta6932.h"
+#include <stdint.h>
+
+// ===== حدود المعدل =====
+// المسح: من 750kHz مضاعفاً حتى هذا الحد (قواسم دقيقة على 48MHz: /64 .. /8)
+#ifndef TA6932_LINK_SWEEP_MIN_HZ
+#define TA6932_LINK_SWEEP_MIN_HZ   750000UL
+#endif
+#ifndef TA6932_LINK_SWEEP_MAX_HZ
+#define TA6932_LINK_SWEEP_MAX_HZ   6000000UL
+#endif
+// عدد الإطارات المختبرة لكل معدل
+#ifndef TA6932_LINK_REPEAT
+#define TA6932_LINK_REPEAT         8
+#endif
+#define TA6932_LINK_MAX_STEPS      8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// تحقق بديل عن القراءة الراجعة (TA6932 لا يملك خط قراءة):
+// حساس ضوئي / كاميرا على منصة الاختبار / نموذج على الحاسوب عبر UART ...
+// يرجع 1 إذا ظهر الإطار frame[16] كما أُرسل.
+typedef uint8_t (*TA6932_LinkCheck)(const uint8_t *frame);
+
+typedef struct {
+  uint32_t hz;           // معدل SPI الفعلي لهذه الخطوة
+  uint8_t  ok;           // نجح (النموذج + التحقق)
+  uint32_t frameCycles;  // متوسط دورات المعالج لإرسال 16 خانة
+} TA6932_LinkStep;
+
+// يمسح المعدلات صعوداً ويتوقف عند أول فشل، ثم يعتمد أسرع معدل ناجح ويحفظه في الفلاش.
+// check إلزامي (لا شيء يُحفظ بلا تحقق فعلي): check = NULL أو رفض clk_gov الانتقال إلى 48MHz
+// (I2C مشغول) → يرجع 0 دون أي إرسال (count = 0). يكتب فوق محتوى الشاشة (أعد الرسم بعده).
+// steps (يمكن NULL) يستقبل سجل الخطوات، count عددها. يرجع المعدل المعتمد أو 0 إن فشل الكل.
+uint32_t TA6932_LinkSweep(TA6932_LinkCheck check, TA6932_LinkStep *steps, uint8_t *count);
+
+// ضبط المعدل يدوياً (سقف؛ يُطبَّق عند كل تغيير للساعة عبر clk_gov)
+void     TA6932_SetLinkRate(uint32_t hz);
+
+// حفظ/استرجاع المعدل (سجل في آخر صفحة فلاش، بلا مسح إلا عند امتلائها)
+HAL_StatusTypeDef TA6932_LinkSave(uint32_t hz);
+uint32_t TA6932_LinkLoad(void);   // يطبّق المعدل المحفوظ ويرجعه، أو 0 إن لم يوجد
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,39 @@
+// TA6932 matrix mode (16x8 LED matrix / bar-graph)
+//Version:1.0
+//Date:19/10/2026
+
+#ifndef __TA6932_MATRIX_H
+#define __TA6932_MATRIX_H
+
+#include "ta6932.h"
+#include <stdint.h>
+
+// x = خانة منطقية (عمود 0..15)، y = بت المقطع (صف 0..7، بلا خريطة الفونت)
+#define TA6932_MATRIX_W  16
+#define TA6932_MATRIX_H  8
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== الرسم في صورة نقطية صفّية (row-major) =====
+// التخزين: بلاطتان 8x8، كل صف بايت (bit x&7)؛ خارج الحدود يُتجاهل
+void    TA6932_MatrixClear(void);
+void    TA6932_MatrixPixel(uint8_t x, uint8_t y, uint8_t on);
+uint8_t TA6932_MatrixGetPixel(uint8_t x, uint8_t y);
+void    TA6932_MatrixHLine(uint8_t x0, uint8_t x1, uint8_t y, uint8_t on);   // صف
+void    TA6932_MatrixVLine(uint8_t x, uint8_t y0, uint8_t y1, uint8_t on);   // عمود
+void    TA6932_MatrixLine(int8_t x0, int8_t y0, int8_t x1, int8_t y1, uint8_t on);  // Bresenham
+void    TA6932_MatrixColumn(uint8_t x, uint8_t bits);  // العمود كاملاً (bit y)، للأعمدة البيانية
+void    TA6932_MatrixBar(uint8_t x, uint8_t height);   // عمود بياني من الصف 7 صعوداً (0..8)
+
+// ===== الإرسال =====
+// يقلب البلاطتين (SWAR 8x8 transpose، 4 كلمات) إلى طبقة BASE بترتيب الخانات ثم WriteAll.
+// الطبقات الأخرى والوميض وخريطة الخانات تبقى سارية.
+void     TA6932_MatrixFlush(void);
+uint32_t TA6932_BenchMatrix(uint16_t n);  // متوسط دورات المعالج لقلب إطار كامل (بدون الإرسال)
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,137 @@
+
+/*
+ * alarm_sched.c  (STM32C0xx-ready)
+ *
+ * Implementation of the DS3231 alarm scheduler (see alarm_sched.h)
+ */
+
+#include "alarm_sched.h"
+
+#define SECONDS_PER_DAY  86400UL
+
+static AlarmSched_Event s_events[ALARMSCHED_MAX_EVENTS];
+static uint8_t s_used = 0;                  // bit per slot
+static AlarmSched_Callback s_minuteCb = NULL;
+
+/* Programmed Alarm 1 target (weekday 1..7 + second of day) */
+static uint8_t  s_tgtDay = 0;               // 0 => nothing programmed
+static uint32_t s_tgtSod = 0;
+
+static volatile uint8_t s_irq = 0;
+
+static uint32_t as_sod(uint8_t h, uint8_t m, uint8_t s){
+    return (uint32_t)h * 3600UL + (uint32_t)m * 60UL + s;
+}
+
+static uint8_t as_dayAllowed(const AlarmSched_Event *ev, uint8_t day){
+    if (day < 1 || day > 7) return 0;       // DY register invalid / not initialized
+    return (ev->days == ALARMSCHED_EVERY_DAY) || (ev->days & (1u << (day - 1)));
+}
+
+/* Finds the earliest event strictly after (day, sod); 0 if none */
+static uint8_t as_next(uint8_t day, uint32_t sod, uint8_t *nday, uint32_t *nsod){
+    uint32_t best = 0xFFFFFFFFUL;
+    if (day < 1 || day > 7) return 0;
+    for (uint8_t i = 0; i < ALARMSCHED_MAX_EVENTS; i++){
+        if (!(s_used & (1u << i))) continue;
+        const AlarmSched_Event *ev = &s_events[i];
+        uint32_t esod = as_sod(ev->hours, ev->minutes, ev->seconds);
+        for (uint8_t k = 0; k <= 7; k++){
+            uint8_t d = (uint8_t)(((day - 1 + k) % 7) + 1);
+            if (k == 0 && esod <= sod) continue;
+            if (!as_dayAllowed(ev, d)) continue;
+            uint32_t delta = k * SECONDS_PER_DAY + esod - sod;
+            if (delta < best){
+                best = delta;
+                *nday = d;
+                *nsod = esod;
+            }
+            break;
+        }
+    }
+    return best != 0xFFFFFFFFUL;
+}
+
+static HAL_StatusTypeDef as_program(uint8_t day, uint32_t sod){
+    uint8_t nday;
+    uint32_t nsod;
+    if (!as_next(day, sod, &nday, &nsod)){
+        s_tgtDay = 0;
+        return DS3231_DisableAlarmInt(DS3231_ALARM_1);
+    }
+    DS3231_AlarmTypeDef a;
+    a.hours   = (uint8_t)(nsod / 3600UL);
+    a.minutes = (uint8_t)((nsod / 60UL) % 60UL);
+    a.seconds = (uint8_t)(nsod % 60UL);
+    a.dayDate = nday;
+    HAL_StatusTypeDef st = DS3231_SetAlarm1(&a, DS3231_A1_MATCH_DAY_HMS);
+    if (st != HAL_OK) return st;
+    s_tgtDay = nday;
+    s_tgtSod = nsod;
+    return DS3231_EnableAlarmInt(DS3231_ALARM_1);
+}
+
+int8_t AlarmSched_Add(const AlarmSched_Event *ev){
+    if (!ev || !ev->cb) return -1;
+    for (uint8_t i = 0; i < ALARMSCHED_MAX_EVENTS; i++){
+        if (s_used & (1u << i)) continue;
+        s_events[i] = *ev;
+        s_used |= (uint8_t)(1u << i);
+        return (int8_t)i;
+    }
+    return -1;
+}
+
+void AlarmSched_Remove(int8_t id){
+    if (id < 0 || id >= ALARMSCHED_MAX_EVENTS) return;
+    s_used &= (uint8_t)~(1u << id);
+}
+
+void AlarmSched_SetMinuteCallback(AlarmSched_Callback cb){ s_minuteCb = cb; }
+
+HAL_StatusTypeDef AlarmSched_Start(void){
+    DS3231_TimeTypeDef now;
+    HAL_StatusTypeDef st = DS3231_GetTime(&now);
+    if (st != HAL_OK) return st;
+    st = DS3231_CheckAlarms(NULL);            // drop stale flags, release INT
+    if (st != HAL_OK) return st;
+
+    if (s_minuteCb){
+        DS3231_AlarmTypeDef a = {0};
+        st = DS3231_SetAlarm2(&a, DS3231_A2_EVERY_MINUTE);
+        if (st == HAL_OK) st = DS3231_EnableAlarmInt(DS3231_ALARM_2);
+    } else {
+        st = DS3231_DisableAlarmInt(DS3231_ALARM_2);
+    }
+    if (st != HAL_OK) return st;
+
+    return as_program(now.day, as_sod(now.hours, now.minutes, now.seconds));
+}
+
+void AlarmSched_OnIrq(void){ s_irq = 1; }
+
+uint8_t AlarmSched_Pending(void){ return s_irq; }
+
+void AlarmSched_Task(void){
+    uint8_t fired = 0;
+    if (!s_irq) return;
+    s_irq = 0;                                // before the read: an edge during it is kept
+    if (DS3231_CheckAlarms(&fired) != HAL_OK){
+        s_irq = 1;                            // flags still set, INT stays low: no new edge, retry
+        return;
+    }
+
+    if ((fired & DS3231_ALARM_2) && s_minuteCb) s_minuteCb(0xFF);
+
+    if ((fired & DS3231_ALARM_1) && s_tgtDay){
+        uint8_t day = s_tgtDay;
+        uint32_t sod = s_tgtSod;
+        for (uint8_t i = 0; i < ALARMSCHED_MAX_EVENTS; i++){
+            if (!(s_used & (1u << i))) continue;
+            const AlarmSched_Event *ev = &s_events[i];
+            if (as_sod(ev->hours, ev->minutes, ev->seconds) == sod && as_dayAllowed(ev, day))
+                ev->cb(i);
+        }
+        (void)as_program(day, sod);           // next event strictly after this one: no time read
+    }
+}
@@ -0,0 +1,90 @@
+
+/*
+ * autobright.c  (STM32C0xx-ready)
+ *
+ * Implementation of the automatic brightness policy (see autobright.h)
+ */
+
+#include "autobright.h"
+#include "ta6932_fade.h"
+
+/* Built-in curve: dim at night, full brightness during the day (both exact hardware steps) */
+static const AutoBright_Point s_defaultCurve[] = {
+    {  0 * 60, AUTOBRIGHT_LEVEL_DIM },
+    {  6 * 60, AUTOBRIGHT_LEVEL_DIM },
+    {  8 * 60, 255 },
+    { 19 * 60, 255 },
+    { 22 * 60, AUTOBRIGHT_LEVEL_DIM },
+};
+
+static const AutoBright_Point *s_curve = s_defaultCurve;
+static uint8_t  s_count = sizeof(s_defaultCurve) / sizeof(s_defaultCurve[0]);
+
+static uint8_t  s_thermal = 0;
+static int16_t  s_startC = 4500;
+static uint8_t  s_perDeg = 16;
+static uint8_t  s_minLevel = AUTOBRIGHT_LEVEL_DIM;
+
+static uint16_t s_lastMinute = 0xFFFF;
+static uint8_t  s_level = 0;
+static uint8_t  s_valid = 0;
+
+void AutoBright_Init(const AutoBright_Point *curve, uint8_t count){
+    if (curve && count){
+        s_curve = curve;
+        s_count = count;
+    } else {
+        s_curve = s_defaultCurve;
+        s_count = sizeof(s_defaultCurve) / sizeof(s_defaultCurve[0]);
+    }
+    s_lastMinute = 0xFFFF; // force evaluation on next snapshot
+    s_valid = 0;
+}
+
+void AutoBright_SetThermal(uint8_t enable, int16_t start_centi, uint8_t per_deg, uint8_t min_level){
+    s_thermal = enable;
+    s_startC = start_centi;
+    s_perDeg = per_deg;
+    s_minLevel = min_level;
+    s_lastMinute = 0xFFFF;
+}
+
+uint8_t AutoBright_WantsTemperature(void){ return s_thermal; }
+
+uint8_t AutoBright_Level(void){ return s_level; }
+
+/* Piecewise-linear lookup, wrapping from the last point back to the first */
+static uint8_t ab_curve(uint16_t mod){
+    uint8_t i = 0;
+    while (i < s_count && s_curve[i].minute <= mod) i++;
+
+    const AutoBright_Point *a = (i == 0) ? &s_curve[s_count - 1] : &s_curve[i - 1];
+    const AutoBright_Point *b = (i == s_count) ? &s_curve[0] : &s_curve[i];
+
+    uint16_t span = (uint16_t)((b->minute + 1440u - a->minute) % 1440u);
+    uint16_t pos  = (uint16_t)((mod + 1440u - a->minute) % 1440u);
+    if (span == 0) return a->level;
+    int32_t d = (int32_t)b->level - (int32_t)a->level;
+    return (uint8_t)((int32_t)a->level + d * (int32_t)pos / (int32_t)span);
+}
+
+static uint8_t ab_derate(uint8_t level, int16_t centi){
+    if (!s_thermal || centi <= s_startC) return level;
+    int32_t cut = ((int32_t)(centi - s_startC) * s_perDeg) / 100;
+    int32_t lv = (int32_t)level - cut;
+    if (lv < s_minLevel) lv = s_minLevel;
+    return (lv < level) ? (uint8_t)lv : level;
+}
+
+void AutoBright_OnSnapshot(const DS3231_TimeTypeDef *time, int16_t centi){
+    if (!time || !s_count) return;
+    uint16_t mod = (uint16_t)(time->hours * 60u + time->minutes);
+    if (mod == s_lastMinute) return;
+    s_lastMinute = mod;
+
+    uint8_t lv = ab_derate(ab_curve(mod), centi);
+    if (s_valid && lv == s_level) return;
+    s_level = lv;
+    s_valid = 1;
+    TA6932_FadeTo(lv, AUTOBRIGHT_FADE_MS, NULL);
+}
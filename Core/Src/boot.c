@@ -0,0 +1,46 @@
+
+/*
+ * boot.c  (STM32C0xx-ready)
+ *
+ * Implementation of the boot timing trace (see boot.h)
+ */
+
+#include "boot.h"
+
+static BOOT_Stage s_trace[BOOT_MAX_STAGES];
+static uint8_t    s_count = 0;
+static uint32_t   s_resetCycles = 0;
+
+void BOOT_CaptureReset(void){
+    /* counts down from 0xFFFFFF since the first instructions of Reset_Handler
+       (a few cycles earlier, constant); cannot wrap before main at 12 MHz */
+    s_resetCycles = 0x00FFFFFFUL - SysTick->VAL;
+}
+
+uint32_t BOOT_ResetCycles(void){
+    return s_resetCycles;
+}
+
+uint32_t BOOT_Micros(void){
+    uint32_t t1, t2, val, load;
+    do {
+        t1   = HAL_GetTick();
+        load = SysTick->LOAD;
+        val  = SysTick->VAL;
+        t2   = HAL_GetTick();
+    } while (t1 != t2);
+    /* fraction of the current 1 ms tick; one division per mark is fine here */
+    return t1 * 1000UL + ((load - val) * 1000UL) / (load + 1UL);
+}
+
+void BOOT_Mark(const char *name){
+    if (s_count >= BOOT_MAX_STAGES) return;
+    s_trace[s_count].name = name;
+    s_trace[s_count].us   = BOOT_Micros();
+    s_count++;
+}
+
+uint8_t BOOT_GetTrace(const BOOT_Stage **trace){
+    if (trace) *trace = s_trace;
+    return s_count;
+}
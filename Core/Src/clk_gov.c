@@ -0,0 +1,132 @@
+
+/*
+ * clk_gov.c  (STM32C0xx-ready)
+ *
+ * Implementation of the clock governor (see clk_gov.h)
+ */
+
+#include "clk_gov.h"
+#include "flash_acc.h"
+#include "i2c_engine.h"
+#include "prof.h"
+
+#define CLKGOV_HSI_HZ          48000000UL
+
+/* I2C1 (PCLK) at <=100 kHz: 48 MHz is the .ioc value (tSCLDEL 250 ns, tSDADEL 0,
+   tSCLH 3.94 us, tSCLL 5.88 us). The others round each of those up to whole
+   tPRESC = (PRESC+1)/f: tSCLDEL = (SCLDEL+1)*tPRESC >= 250 ns (tSU;DAT min),
+   SDADEL 0, (SCLH+1)*tPRESC >= 3.94 us, (SCLL+1)*tPRESC >= 5.88 us.
+     24 MHz: 250 ns / 3.96 / 5.88    12 MHz: 250 ns / 4.00 / 5.92
+      6 MHz: 333 ns / 4.00 / 6.00     3 MHz: 333 ns / 4.00 / 6.00 */
+static const uint32_t s_i2cTiming[CLKGOV_LEVELS] = {
+    0x20303E5D, 0x00505E8C, 0x00202F46, 0x00101723, 0x00000B11
+};
+
+static const uint32_t s_hsiDiv[CLKGOV_LEVELS] = {
+    RCC_HSI_DIV1, RCC_HSI_DIV2, RCC_HSI_DIV4, RCC_HSI_DIV8, RCC_HSI_DIV16
+};
+
+static SPI_HandleTypeDef *s_spi = NULL;
+static I2C_HandleTypeDef *s_i2c = NULL;
+static ClkGov_Level       s_level = CLKGOV_48MHZ;
+static ClkGov_Stats       s_stats;
+static uint32_t           s_spiMaxHz = CLKGOV_SPI_HZ;
+static ClkGov_SwitchHook  s_hook = NULL;
+
+void ClkGov_Init(SPI_HandleTypeDef *hspi, I2C_HandleTypeDef *hi2c){
+    s_spi   = hspi;
+    s_i2c   = hi2c;
+    s_level = CLKGOV_48MHZ;   // SystemClock_Config(): HSI_DIV1
+    PROF_Register("clk.switch", &s_stats.switches);
+    PROF_Register("clk.worst",  &s_stats.worstCycles);
+}
+
+void ClkGov_SetSwitchHook(ClkGov_SwitchHook hook){
+    s_hook = hook;
+}
+
+/* Smallest SPI divider (2..256) with pclk/div <= s_spiMaxHz, as a CR1.BR value */
+static uint32_t gov_spiBr(uint32_t pclk_hz){
+    uint32_t br = 0;
+    while (br < 7 && (pclk_hz >> (br + 1)) > s_spiMaxHz) br++;
+    return br << SPI_CR1_BR_Pos;
+}
+
+static void gov_retimeSpi(uint32_t pclk_hz){
+    uint32_t br, spe;
+    if (!s_spi) return;
+    br  = gov_spiBr(pclk_hz);
+    spe = READ_BIT(s_spi->Instance->CR1, SPI_CR1_SPE);
+    /* BR can only change with SPE=0 */
+    CLEAR_BIT(s_spi->Instance->CR1, SPI_CR1_SPE);
+    MODIFY_REG(s_spi->Instance->CR1, SPI_CR1_BR, br);
+    s_spi->Init.BaudRatePrescaler = br;
+    SET_BIT(s_spi->Instance->CR1, spe);   // DMA refresh keeps running
+}
+
+static void gov_retimeBuses(ClkGov_Level level){
+    gov_retimeSpi(CLKGOV_HSI_HZ >> level);
+    if (s_i2c){
+        /* TIMINGR can only change with PE=0 */
+        CLEAR_BIT(s_i2c->Instance->CR1, I2C_CR1_PE);
+        s_i2c->Instance->TIMINGR = s_i2cTiming[level];
+        s_i2c->Init.Timing       = s_i2cTiming[level];
+        SET_BIT(s_i2c->Instance->CR1, I2C_CR1_PE);
+    }
+}
+
+HAL_StatusTypeDef ClkGov_SetLevel(ClkGov_Level level){
+    uint32_t hz, t0, cycles;
+
+    if (level >= CLKGOV_LEVELS) return HAL_ERROR;
+    if (level == s_level) return HAL_OK;
+    /* also a read the engine did not start (DS3231 mailbox DMA) */
+    if (I2CEng_Busy() || (s_i2c && READ_BIT(s_i2c->Instance->ISR, I2C_ISR_BUSY))){
+        s_stats.refused++;
+        return HAL_BUSY;
+    }
+
+    hz = CLKGOV_HSI_HZ >> level;
+    if (s_hook) s_hook(1);            // e.g. DMA refresh parked between two frames
+    t0 = PROF_Stamp();                // SysTick counts HCLK cycles at either speed
+
+    if (level < s_level){
+        /* faster: wait states first, then the clock */
+        FlashAcc_ApplyForClock(hz);
+        __HAL_RCC_HSI_CONFIG(s_hsiDiv[level]);
+    } else {
+        /* slower: clock first, then drop the wait states */
+        __HAL_RCC_HSI_CONFIG(s_hsiDiv[level]);
+        FlashAcc_ApplyForClock(hz);
+    }
+    gov_retimeBuses(level);
+    cycles = PROF_Cycles(t0);          // read before SysTick is reloaded
+
+    SystemCoreClock = hz;
+    HAL_InitTick(uwTickPrio);          // keep the 1 ms tick
+    if (s_hook) s_hook(0);
+
+    s_level = level;
+    s_stats.switches++;
+    s_stats.lastCycles = cycles;
+    if (cycles > s_stats.worstCycles) s_stats.worstCycles = cycles;
+    return HAL_OK;
+}
+
+void ClkGov_SetSpiRate(uint32_t max_hz){
+    s_spiMaxHz = max_hz;
+    gov_retimeSpi(CLKGOV_HSI_HZ >> s_level);
+}
+
+uint32_t ClkGov_SpiRate(void){
+    uint32_t br = gov_spiBr(CLKGOV_HSI_HZ >> s_level) >> SPI_CR1_BR_Pos;
+    return (CLKGOV_HSI_HZ >> s_level) >> (br + 1);
+}
+
+ClkGov_Level ClkGov_GetLevel(void){
+    return s_level;
+}
+
+const ClkGov_Stats *ClkGov_GetStats(void){
+    return &s_stats;
+}
@@ -0,0 +1,183 @@
+
+/*
+ * ds3231_cal.c  (STM32C0xx-ready)
+ *
+ * Implementation of the DS3231 aging-offset compensation service (see ds3231_cal.h)
+ */
+
+#include "ds3231_cal.h"
+
+#define RESYNC_MIN_S   60UL
+#define RESYNC_MAX_S   86400UL
+#define UNCALIBRATED_PPB  2000   // DS3231 spec, 0..40 C
+
+/* Guards the window state shared with RtcCal_OnSqwEdge (overridable for host tests) */
+#ifndef RTCCAL_IRQ_OFF
+#define RTCCAL_IRQ_OFF()  __disable_irq()
+#define RTCCAL_IRQ_ON()   __enable_irq()
+#endif
+
+static RtcCal_Port s_port;
+
+/* Measurement window (edges captured in interrupt context) */
+static volatile uint8_t  s_active = 0;
+static volatile uint8_t  s_done = 0;
+static volatile uint32_t s_edges = 0;
+static volatile uint32_t s_lastRef = 0;
+static volatile uint64_t s_refSum = 0;
+static uint16_t s_window = 0;
+
+static int32_t  s_lastDrift = 0;
+static int32_t  s_residual = 0;
+
+static RtcCal_LogEntry s_log[RTCCAL_LOG_SIZE];
+static uint8_t  s_logHead = 0;
+static uint8_t  s_logCount = 0;
+
+/* Software clock */
+static uint32_t s_syncEpoch = 0;
+static uint32_t s_syncRef = 0;             // reference tick of the last whole second counted
+static uint32_t s_syncSecs = 0;            // whole seconds since the sync
+static uint8_t  s_synced = 0;
+
+/* Whole seconds are moved from the 32-bit tick difference into s_syncSecs as they
+ * elapse, so only the time between two calls (not since the sync) must stay below
+ * the refNow wrap (2^32 / refHz: ~89 s at 48 MHz) */
+static uint32_t cal_sinceSyncS(void){
+    uint32_t n = (uint32_t)(s_port.refNow() - s_syncRef) / s_port.refHz;
+    s_syncRef  += n * s_port.refHz;
+    s_syncSecs += n;
+    return s_syncSecs;
+}
+
+static HAL_StatusTypeDef cal_writeAging(int8_t aging){
+    HAL_StatusTypeDef st = DS3231_WriteAging(aging);
+    if (st != HAL_OK) return st;
+    return DS3231_StartConversion();
+}
+
+void RtcCal_Init(const RtcCal_Port *port){
+    s_port = *port;
+    if (!s_port.readAging)     s_port.readAging = DS3231_ReadAging;
+    if (!s_port.writeAging)    s_port.writeAging = cal_writeAging;
+    if (!s_port.readTempCenti) s_port.readTempCenti = DS3231_ReadTemperatureCenti;
+    if (!s_port.enableSqw)     s_port.enableSqw = DS3231_Enable1HzSQW;
+    s_active = 0;
+    s_done = 0;
+    s_synced = 0;
+    s_residual = UNCALIBRATED_PPB;
+}
+
+HAL_StatusTypeDef RtcCal_Start(uint16_t window_s){
+    if (!s_port.refNow || !s_port.refHz || !window_s) return HAL_ERROR;
+    HAL_StatusTypeDef st = s_port.enableSqw();
+    if (st != HAL_OK) return st;
+    RTCCAL_IRQ_OFF();
+    s_window = window_s;
+    s_edges = 0;
+    s_refSum = 0;
+    s_done = 0;
+    s_active = 1;
+    RTCCAL_IRQ_ON();
+    return HAL_OK;
+}
+
+uint8_t RtcCal_Active(void){ return s_active; }
+
+void RtcCal_OnSqwEdge(void){
+    if (!s_active) return;
+    uint32_t now = s_port.refNow();
+    if (s_edges)  s_refSum += (uint32_t)(now - s_lastRef); // per-edge delta: no 32-bit wrap issue
+    s_lastRef = now;
+    if (++s_edges > s_window){
+        s_active = 0;
+        s_done = 1;
+    }
+}
+
+int32_t RtcCal_DriftPpb(uint64_t ref_elapsed, uint32_t seconds, uint32_t ref_hz){
+    uint64_t expected = (uint64_t)seconds * ref_hz;
+    if (!expected) return 0;
+    int64_t diff = (int64_t)ref_elapsed - (int64_t)expected;
+    return (int32_t)((diff * 1000000000LL) / (int64_t)expected);
+}
+
+int8_t RtcCal_NextAging(int8_t aging, int32_t drift_ppb){
+    /* RTC slow (drift > 0) => speed it up => lower aging. Round to nearest LSB. */
+    int32_t lsb = (drift_ppb >= 0) ? (drift_ppb + RTCCAL_PPB_PER_LSB / 2) / RTCCAL_PPB_PER_LSB
+                                   : (drift_ppb - RTCCAL_PPB_PER_LSB / 2) / RTCCAL_PPB_PER_LSB;
+    int32_t v = (int32_t)aging - lsb;
+    if (v > 127)  v = 127;
+    if (v < -128) v = -128;
+    return (int8_t)v;
+}
+
+static void cal_log(int32_t drift, int16_t temp, int8_t aging){
+    RtcCal_LogEntry *e = &s_log[s_logHead];
+    e->drift_ppb = drift;
+    e->temp_centi = temp;
+    e->aging = aging;
+    s_logHead = (uint8_t)((s_logHead + 1) % RTCCAL_LOG_SIZE);
+    if (s_logCount < RTCCAL_LOG_SIZE) s_logCount++;
+}
+
+uint8_t RtcCal_Task(void){
+    if (s_synced && s_port.refNow) (void)cal_sinceSyncS();   // fold seconds in before refNow wraps
+    if (!s_done) return 0;
+    s_done = 0;
+
+    int8_t  aging = 0;
+    int16_t temp = 0;
+    uint64_t sum;
+    RTCCAL_IRQ_OFF();
+    sum = s_refSum;
+    RTCCAL_IRQ_ON();
+
+    s_lastDrift = RtcCal_DriftPpb(sum, s_window, s_port.refHz);
+    (void)s_port.readTempCenti(&temp);
+    if (s_port.readAging(&aging) != HAL_OK) return 1;
+    cal_log(s_lastDrift, temp, aging);
+
+    int8_t next = RtcCal_NextAging(aging, s_lastDrift);
+    s_residual = s_lastDrift + ((int32_t)next - aging) * RTCCAL_PPB_PER_LSB;
+    if (next != aging) (void)s_port.writeAging(next);
+    return 1;
+}
+
+int32_t RtcCal_LastDriftPpb(void){ return s_lastDrift; }
+int32_t RtcCal_ResidualPpb(void){ return s_residual; }
+
+uint8_t RtcCal_GetLog(RtcCal_LogEntry *out, uint8_t max){
+    uint8_t n = (s_logCount < max) ? s_logCount : max;
+    uint8_t first = (uint8_t)((s_logHead + RTCCAL_LOG_SIZE - s_logCount) % RTCCAL_LOG_SIZE);
+    for (uint8_t i = 0; i < n; i++) out[i] = s_log[(first + i) % RTCCAL_LOG_SIZE];
+    return n;
+}
+
+/* ===== Cached software clock ===== */
+void RtcCal_ClockSync(uint32_t epoch){
+    s_syncEpoch = epoch;
+    s_syncRef = s_port.refNow ? s_port.refNow() : 0;
+    s_syncSecs = 0;
+    s_synced = 1;
+}
+
+uint32_t RtcCal_ClockNow(void){
+    if (!s_synced || !s_port.refNow) return s_syncEpoch;
+    return s_syncEpoch + cal_sinceSyncS();
+}
+
+uint32_t RtcCal_ResyncIntervalS(uint32_t tolerance_ms){
+    uint32_t r = (uint32_t)((s_residual < 0) ? -s_residual : s_residual);
+    if (r == 0) return RESYNC_MAX_S;
+    /* ms / ppb = 1e6 s */
+    uint64_t s = ((uint64_t)tolerance_ms * 1000000ULL) / r;
+    if (s < RESYNC_MIN_S) return RESYNC_MIN_S;
+    if (s > RESYNC_MAX_S) return RESYNC_MAX_S;
+    return (uint32_t)s;
+}
+
+uint8_t RtcCal_ClockNeedsSync(uint32_t tolerance_ms){
+    if (!s_synced || !s_port.refNow) return 1;
+    return cal_sinceSyncS() >= RtcCal_ResyncIntervalS(tolerance_ms);
+}
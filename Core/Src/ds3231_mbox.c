@@ -0,0 +1,203 @@
+
+/*
+ * ds3231_mbox.c  (STM32C0xx-ready)
+ *
+ * Implementation of the hardware-filled DS3231 time mailbox (see ds3231_mbox.h)
+ */
+
+#include "ds3231_mbox.h"
+#include "string.h"
+
+/* DS3231 is on I2C1 (the DMA request is I2C1_RX) */
+#define MB_I2C        I2C1
+/* EXTI line of INT/SQW, and the matching generator signal */
+#define MB_EXTI_LINE  ((uint32_t)DS3231_INT_PIN)
+#define MB_GEN_SIGNAL (HAL_DMAMUX1_REQ_GEN_EXTI0 + POSITION_VAL(DS3231_INT_PIN))
+
+static DMA_HandleTypeDef s_cr2Dma;     // generator 0 -> I2C1->CR2
+static DMA_HandleTypeDef s_rxDma;      // I2C1->RXDR -> s_box (circular)
+
+static uint32_t s_cr2Word;             // DMA source: read RTCMBOX_LEN bytes, AUTOEND, START
+static volatile uint8_t s_box[RTCMBOX_LEN];
+static uint8_t  s_primeBuf[RTCMBOX_LEN];
+
+static uint8_t  s_active = 0;
+static uint8_t  s_armed = 0;
+static uint8_t  s_primed = 0;          // DS3231 pointer known to be at 0x00
+static uint8_t  s_valid = 0;           // s_box holds a complete read
+static uint8_t  s_nack = 0;            // last autonomous read was not acknowledged
+
+static void mb_primeDone(HAL_StatusTypeDef st, void *ctx);
+static const I2CEng_Req s_primeReq = {
+    DS3231_I2C_ADDR, DS3231_REG_SECONDS, I2CENG_READ, s_primeBuf, RTCMBOX_LEN,
+    DS3231_I2C_TIMEOUT_MS, mb_primeDone, NULL
+};
+
+/* Waits for a read started by the generator to end (AUTOEND releases the bus) */
+static uint8_t mb_waitIdle(void){
+    uint32_t t0 = HAL_GetTick();
+    while (READ_BIT(MB_I2C->ISR, I2C_ISR_BUSY)){
+        if ((HAL_GetTick() - t0) >= DS3231_I2C_TIMEOUT_MS) return 0;
+    }
+    return 1;
+}
+
+static void mb_disarm(void){
+    if (!s_armed) return;
+    (void)HAL_DMAEx_DisableMuxRequestGenerator(&s_cr2Dma);
+    /* a request latched just before GE=0 still lands in CR2: let it start */
+    for (volatile uint8_t i = 8; i; i--) { }
+    if (!mb_waitIdle()) s_valid = 0;   // the engine recovers the bus on its first timeout
+    CLEAR_BIT(MB_I2C->CR1, I2C_CR1_RXDMAEN);
+    if (READ_BIT(MB_I2C->ISR, I2C_ISR_NACKF)) s_nack = 1;
+    /* HAL IT transfers would take a stale STOPF/NACKF for their own */
+    MB_I2C->ICR = I2C_ICR_STOPCF | I2C_ICR_NACKCF;
+    s_armed = 0;
+}
+
+static void mb_arm(void){
+    /* restart the circular channel so byte 0 is the seconds register again */
+    (void)HAL_DMA_Abort(&s_rxDma);
+    if (HAL_DMA_Start(&s_rxDma, (uint32_t)&MB_I2C->RXDR, (uint32_t)s_box, RTCMBOX_LEN) != HAL_OK) return;
+    MB_I2C->ICR = I2C_ICR_STOPCF | I2C_ICR_NACKCF;
+    SET_BIT(MB_I2C->CR1, I2C_CR1_RXDMAEN);
+    if (HAL_DMAEx_EnableMuxRequestGenerator(&s_cr2Dma) != HAL_OK){
+        CLEAR_BIT(MB_I2C->CR1, I2C_CR1_RXDMAEN);
+        return;
+    }
+    s_armed = 1;
+}
+
+static void mb_primeDone(HAL_StatusTypeDef st, void *ctx){
+    (void)ctx;
+    if (st != HAL_OK || !s_active) return;
+    memcpy((void*)s_box, s_primeBuf, RTCMBOX_LEN);  // not armed: DMA is not writing s_box
+    s_primed = 1;
+    s_valid = 1;
+    s_nack = 0;
+}
+
+/* I2C engine bus hook: step aside while it owns the bus, re-prime and re-arm after */
+static void mb_busHook(uint8_t acquire){
+    if (!s_active) return;
+    if (acquire){
+        mb_disarm();
+        s_primed = 0;                  // the engine's transfer moves the DS3231 pointer
+    } else if (s_primed){
+        mb_arm();
+    } else {
+        (void)I2CEng_Submit(&s_primeReq);   // on failure: retried from RtcMbox_Get()
+    }
+}
+
+/* INT/SQW line: DMAMUX event only (no CPU interrupt) or back to the falling-edge IRQ */
+static void mb_exti(uint8_t mailbox){
+    if (mailbox){
+        CLEAR_BIT(EXTI->IMR1, MB_EXTI_LINE);
+#if RTCMBOX_EDGE_RISING
+        SET_BIT(EXTI->RTSR1, MB_EXTI_LINE);
+        CLEAR_BIT(EXTI->FTSR1, MB_EXTI_LINE);
+#endif
+        SET_BIT(EXTI->EMR1, MB_EXTI_LINE);
+    } else {
+        CLEAR_BIT(EXTI->EMR1, MB_EXTI_LINE);
+        CLEAR_BIT(EXTI->RTSR1, MB_EXTI_LINE);
+        SET_BIT(EXTI->FTSR1, MB_EXTI_LINE);
+        EXTI->RPR1 = MB_EXTI_LINE;
+        EXTI->FPR1 = MB_EXTI_LINE;
+        SET_BIT(EXTI->IMR1, MB_EXTI_LINE);
+    }
+}
+
+HAL_StatusTypeDef RtcMbox_Start(void){
+    HAL_DMA_MuxRequestGeneratorConfigTypeDef gen;
+    HAL_StatusTypeDef st;
+
+    if (s_active) return HAL_OK;
+    st = DS3231_Enable1HzSQW();
+    if (st != HAL_OK) return st;
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    s_cr2Word = (uint32_t)DS3231_I2C_ADDR | I2C_CR2_RD_WRN |
+                ((uint32_t)RTCMBOX_LEN << I2C_CR2_NBYTES_Pos) | I2C_CR2_AUTOEND | I2C_CR2_START;
+
+    s_cr2Dma.Instance                 = RTCMBOX_CR2_DMA_CH;
+    s_cr2Dma.Init.Request             = DMA_REQUEST_GENERATOR0;
+    s_cr2Dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    s_cr2Dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    s_cr2Dma.Init.MemInc              = DMA_MINC_DISABLE;
+    s_cr2Dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    s_cr2Dma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    s_cr2Dma.Init.Mode                = DMA_CIRCULAR;
+    s_cr2Dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&s_cr2Dma) != HAL_OK) return HAL_ERROR;
+    gen.SignalID      = MB_GEN_SIGNAL;
+    gen.Polarity      = HAL_DMAMUX_REQ_GEN_RISING;   // EXTI event pulse; the pin edge is RTSR/FTSR
+    gen.RequestNumber = 1;                           // one CR2 write per edge
+    if (HAL_DMAEx_ConfigMuxRequestGenerator(&s_cr2Dma, &gen) != HAL_OK) return HAL_ERROR;
+    if (HAL_DMA_Start(&s_cr2Dma, (uint32_t)&s_cr2Word, (uint32_t)&MB_I2C->CR2, 1) != HAL_OK) return HAL_ERROR;
+
+    s_rxDma.Instance                 = RTCMBOX_RX_DMA_CH;
+    s_rxDma.Init.Request             = DMA_REQUEST_I2C1_RX;
+    s_rxDma.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    s_rxDma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    s_rxDma.Init.MemInc              = DMA_MINC_ENABLE;
+    s_rxDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    s_rxDma.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    s_rxDma.Init.Mode                = DMA_CIRCULAR;
+    s_rxDma.Init.Priority            = DMA_PRIORITY_MEDIUM;
+    if (HAL_DMA_Init(&s_rxDma) != HAL_OK) return HAL_ERROR;
+
+    mb_exti(1);
+    s_armed = 0;
+    s_primed = 0;
+    s_valid = 0;
+    s_nack = 0;
+    s_active = 1;
+    I2CEng_SetBusHook(mb_busHook);
+    if (!I2CEng_Busy()) (void)I2CEng_Submit(&s_primeReq);   // else primed when the queue drains
+    return HAL_OK;
+}
+
+void RtcMbox_Stop(void){
+    if (!s_active) return;
+    I2CEng_SetBusHook(NULL);
+    mb_disarm();
+    (void)HAL_DMA_Abort(&s_cr2Dma);
+    (void)HAL_DMA_Abort(&s_rxDma);
+    (void)HAL_DMA_DeInit(&s_cr2Dma);
+    (void)HAL_DMA_DeInit(&s_rxDma);
+    mb_exti(0);
+    s_active = 0;
+}
+
+uint8_t RtcMbox_Active(void){ return s_active; }
+uint8_t RtcMbox_Armed(void){ return s_armed; }
+
+HAL_StatusTypeDef RtcMbox_GetRaw(uint8_t raw[RTCMBOX_LEN]){
+    if (!s_active) return HAL_ERROR;
+    if (!s_armed && !I2CEng_Busy()) (void)I2CEng_Submit(&s_primeReq);
+    if (s_armed){
+        /* a read takes ~2 ms, the copy a few us: idle before and after => not torn */
+        for (uint8_t n = 0; ; n++){
+            if (n == 3 || !mb_waitIdle()) return HAL_BUSY;
+            memcpy(raw, (const void*)s_box, RTCMBOX_LEN);
+            if (!READ_BIT(MB_I2C->ISR, I2C_ISR_BUSY)) break;
+        }
+        if (READ_BIT(MB_I2C->ISR, I2C_ISR_NACKF)) return HAL_ERROR;
+        if (__HAL_DMA_GET_COUNTER(&s_rxDma) != RTCMBOX_LEN) return HAL_BUSY;   // read cut short
+        return s_valid ? HAL_OK : HAL_BUSY;
+    }
+    if (!s_valid) return HAL_BUSY;
+    memcpy(raw, (const void*)s_box, RTCMBOX_LEN);  // last read before the engine took the bus
+    return s_nack ? HAL_ERROR : HAL_OK;
+}
+
+HAL_StatusTypeDef RtcMbox_Get(DS3231_TimeTypeDef *time, int16_t *centi){
+    uint8_t raw[RTCMBOX_LEN];
+    HAL_StatusTypeDef st = RtcMbox_GetRaw(raw);
+    if (st != HAL_OK) return st;
+    DS3231_DecodeTime(raw, time);
+    if (centi) *centi = DS3231_TempRawToCenti(raw[DS3231_REG_TEMP_MSB], raw[DS3231_REG_TEMP_LSB]);
+    return HAL_OK;
+}
@@ -0,0 +1,91 @@
+
+/*
+ * ds3231_time.c  (STM32C0xx-ready)
+ *
+ * Implementation of DS3231 calendar arithmetic (see ds3231_time.h)
+ */
+
+#include "ds3231_time.h"
+
+#define SECONDS_PER_DAY   86400UL
+#define DAYS_PER_4YEARS   1461u   // 366 + 3*365 (2000 is leap)
+
+/* Days before the 1st of each month, non-leap year ([12] = 365 sentinel) */
+static const uint16_t s_cumDays[13] = {
+    0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365
+};
+
+uint8_t DS3231_IsLeapYear(uint16_t year){
+    return (uint8_t)((year & 3u) == 0);      // exact for 2000..2099
+}
+
+uint8_t DS3231_DaysInMonth(uint16_t year, uint8_t month){
+    if (month < 1 || month > 12) return 0;
+    uint8_t n = (uint8_t)(s_cumDays[month] - s_cumDays[month - 1]);
+    return (uint8_t)(n + (month == 2 && DS3231_IsLeapYear(year)));
+}
+
+uint16_t DS3231_DaysSince2000(uint16_t year, uint8_t month, uint8_t date){
+    if (month < 1 || month > 12 || date < 1) return 0;    // corrupt register: no table overrun
+    uint16_t y = (uint16_t)(year - 2000u);
+    uint16_t d = (uint16_t)(y * 365u + ((y + 3u) >> 2));   // leap days in the years before y
+    d = (uint16_t)(d + s_cumDays[month - 1] + date - 1u);
+    if (month > 2 && (y & 3u) == 0) d++;
+    return d;
+}
+
+uint8_t DS3231_DayOfWeek(uint16_t year, uint8_t month, uint8_t date){
+    /* 2000-01-01 was a Saturday (7) */
+    return (uint8_t)((DS3231_DaysSince2000(year, month, date) + 6u) % 7u + 1u);
+}
+
+uint32_t DS3231_ToEpoch(const DS3231_TimeTypeDef *t){
+    uint32_t days = DS3231_DaysSince2000(t->year, t->month, t->date);
+    return DS3231_EPOCH_2000 + days * SECONDS_PER_DAY
+         + (uint32_t)t->hours * 3600UL + (uint32_t)t->minutes * 60UL + t->seconds;
+}
+
+void DS3231_FromEpoch(uint32_t epoch, DS3231_TimeTypeDef *t){
+    uint32_t s    = epoch - DS3231_EPOCH_2000;
+    uint16_t days = (uint16_t)(s / SECONDS_PER_DAY);
+    uint32_t sod  = s - (uint32_t)days * SECONDS_PER_DAY;
+
+    t->hours   = (uint8_t)(sod / 3600UL);
+    sod       -= (uint32_t)t->hours * 3600UL;
+    t->minutes = (uint8_t)(sod / 60u);
+    t->seconds = (uint8_t)(sod - t->minutes * 60u);
+    t->day     = (uint8_t)((days + 6u) % 7u + 1u);
+
+    /* Year: 4-year cycle, first year of each cycle is the leap one */
+    uint16_t cyc = (uint16_t)(days / DAYS_PER_4YEARS);
+    uint16_t r   = (uint16_t)(days - cyc * DAYS_PER_4YEARS);
+    uint16_t yic, doy;
+    uint8_t  leap;
+    if (r < 366u){
+        yic = 0; doy = r; leap = 1;
+    } else {
+        r  -= 366u;
+        yic = (uint16_t)(1u + r / 365u);
+        doy = (uint16_t)(r % 365u);
+        leap = 0;
+    }
+    t->year = (uint16_t)(2000u + cyc * 4u + yic);
+
+    /* Month: doy>>5 is the month or one less; one table compare fixes it */
+    if (leap){
+        if (doy == 59u){ t->month = 2; t->date = 29; return; }
+        if (doy > 59u) doy--;
+    }
+    uint8_t m = (uint8_t)(doy >> 5);
+    if (doy >= s_cumDays[m + 1]) m++;
+    t->month = (uint8_t)(m + 1u);
+    t->date  = (uint8_t)(doy - s_cumDays[m] + 1u);
+}
+
+void DS3231_AddSeconds(DS3231_TimeTypeDef *t, int32_t seconds){
+    DS3231_FromEpoch(DS3231_ToEpoch(t) + (uint32_t)seconds, t);
+}
+
+int32_t DS3231_DiffSeconds(const DS3231_TimeTypeDef *a, const DS3231_TimeTypeDef *b){
+    return (int32_t)(DS3231_ToEpoch(a) - DS3231_ToEpoch(b));
+}
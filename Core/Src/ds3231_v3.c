@@ -7,6 +7,7 @@
  */
 
 #include "ds3231_v3.h"
+#include "ds3231_time.h"
 #include "string.h"
 
 static I2C_HandleTypeDef *hI2C = NULL;
@@ -15,44 +16,88 @@ static I2C_HandleTypeDef *hI2C = NULL;
 uint8_t DS3231_BCD2BIN(uint8_t val){ return (uint8_t)((val>>4)*10 + (val&0x0F)); }
 uint8_t DS3231_BIN2BCD(uint8_t val){ return (uint8_t)(((val/10)<<4) | (val%10)); }
 
-void DS3231_Init(I2C_HandleTypeDef *hi2c){ hI2C = hi2c; }
+void DS3231_Init(I2C_HandleTypeDef *hi2c){
+    hI2C = hi2c;
+    I2CEng_Init(hi2c);
+}
 
-/* Low-level R/W */
-static HAL_StatusTypeDef ds_write(uint8_t reg, const uint8_t *pdata, uint16_t size){
+/* Low-level R/W: bounded transfers on the I2C engine (no 1000 ms HAL timeout) */
+static HAL_StatusTypeDef ds_xfer(uint8_t dir, uint8_t reg, uint8_t *pdata, uint16_t size){
     if (!hI2C) return HAL_ERROR;
-    return HAL_I2C_Mem_Write(hI2C, DS3231_I2C_ADDR, reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*)pdata, size, 1000);
+    I2CEng_Req r = { DS3231_I2C_ADDR, reg, dir, pdata, size, DS3231_I2C_TIMEOUT_MS, NULL, NULL };
+    return I2CEng_Transfer(&r);
+}
+static HAL_StatusTypeDef ds_write(uint8_t reg, const uint8_t *pdata, uint16_t size){
+    return ds_xfer(I2CENG_WRITE, reg, (uint8_t*)pdata, size);
 }
 static HAL_StatusTypeDef ds_read(uint8_t reg, uint8_t *pdata, uint16_t size){
-    if (!hI2C) return HAL_ERROR;
-    return HAL_I2C_Mem_Read(hI2C, DS3231_I2C_ADDR, reg, I2C_MEMADD_SIZE_8BIT, pdata, size, 1000);
+    return ds_xfer(I2CENG_READ, reg, pdata, size);
 }
 
 /* Basic time I/O */
-HAL_StatusTypeDef DS3231_SetTime(DS3231_TimeTypeDef *time){
-    if (!time) return HAL_ERROR;
-    uint8_t buf[7];
+static void ds_encodeTime(const DS3231_TimeTypeDef *time, uint8_t *buf){
     buf[0]=DS3231_BIN2BCD(time->seconds);
     buf[1]=DS3231_BIN2BCD(time->minutes);
     buf[2]=DS3231_BIN2BCD(time->hours);
-    buf[3]=DS3231_BIN2BCD(time->day);
+    buf[3]=DS3231_DayOfWeek(time->year, time->month, time->date); // derived, 1..7
     buf[4]=DS3231_BIN2BCD(time->date);
     buf[5]=DS3231_BIN2BCD(time->month);
     buf[6]=DS3231_BIN2BCD((uint8_t)(time->year%100));
-    return ds_write(DS3231_REG_SECONDS, buf, 7);
 }
-HAL_StatusTypeDef DS3231_GetTime(DS3231_TimeTypeDef *time){
+HAL_StatusTypeDef DS3231_SetTime(DS3231_TimeTypeDef *time){
+    if (!time) return HAL_ERROR;
     uint8_t buf[7];
-    HAL_StatusTypeDef st = ds_read(DS3231_REG_SECONDS, buf, 7);
-    if (st!=HAL_OK) return st;
+    ds_encodeTime(time, buf);
+    return ds_write(DS3231_REG_SECONDS, buf, 7);
+}
+void DS3231_DecodeTime(const uint8_t *buf, DS3231_TimeTypeDef *time){
     time->seconds=(uint8_t)DS3231_BCD2BIN(buf[0]&0x7F);
     time->minutes=(uint8_t)DS3231_BCD2BIN(buf[1]&0x7F);
     time->hours  =(uint8_t)DS3231_BCD2BIN(buf[2]&0x3F); // 24h
-    time->day    =(uint8_t)DS3231_BCD2BIN(buf[3]&0x07);
     time->date   =(uint8_t)DS3231_BCD2BIN(buf[4]&0x3F);
     time->month  =(uint8_t)DS3231_BCD2BIN(buf[5]&0x1F);
     time->year   =(uint16_t)(2000 + DS3231_BCD2BIN(buf[6]));
+    time->day    =DS3231_DayOfWeek(time->year, time->month, time->date); // not the register
+}
+/* Weekday derived from the date registers (raw 0x00..0x06), as written by SetTime */
+static uint8_t ds_derivedDay(const uint8_t *buf){
+    DS3231_TimeTypeDef t;
+    DS3231_DecodeTime(buf, &t);
+    return t.day;
+}
+HAL_StatusTypeDef DS3231_GetTime(DS3231_TimeTypeDef *time){
+    uint8_t buf[7];
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_SECONDS, buf, 7);
+    if (st!=HAL_OK) return st;
+    DS3231_DecodeTime(buf, time);
     return HAL_OK;
 }
+HAL_StatusTypeDef DS3231_GetTimeRaw(uint8_t raw[7]){
+    return ds_read(DS3231_REG_SECONDS, raw, 7);
+}
+
+/* Non-blocking time read: decoded into *time, then cb(status) from I2CEng_Task() */
+static uint8_t             s_asyncRaw[7];
+static DS3231_TimeTypeDef *s_asyncTime = NULL;
+static DS3231_DoneCallback s_asyncCb = NULL;
+
+static void ds_getTimeDone(HAL_StatusTypeDef st, void *ctx){
+    (void)ctx;
+    if (st == HAL_OK && s_asyncTime) DS3231_DecodeTime(s_asyncRaw, s_asyncTime);
+    s_asyncTime = NULL;
+    if (s_asyncCb) s_asyncCb(st);
+}
+HAL_StatusTypeDef DS3231_GetTimeAsync(DS3231_TimeTypeDef *time, DS3231_DoneCallback cb){
+    if (!hI2C || !time) return HAL_ERROR;
+    if (s_asyncTime) return HAL_BUSY;
+    I2CEng_Req r = { DS3231_I2C_ADDR, DS3231_REG_SECONDS, I2CENG_READ, s_asyncRaw, 7,
+                     DS3231_I2C_TIMEOUT_MS, ds_getTimeDone, NULL };
+    s_asyncTime = time;
+    s_asyncCb = cb;
+    HAL_StatusTypeDef st = I2CEng_Submit(&r);
+    if (st != HAL_OK) s_asyncTime = NULL;
+    return st;
+}
 
 /* SQW control */
 HAL_StatusTypeDef DS3231_Enable1HzSQW(void){
@@ -72,14 +117,35 @@ HAL_StatusTypeDef DS3231_DisableSQW(void){
     return ds_write(DS3231_REG_CONTROL, &ctrl, 1);
 }
 
-/* Temperature */
-HAL_StatusTypeDef DS3231_ReadTemperature(float *temperature){
+/* Temperature: MSB = signed integer part, LSB bits 7..6 = quarter degrees */
+int16_t DS3231_TempRawToCenti(uint8_t msb, uint8_t lsb){
+    return (int16_t)((int16_t)(int8_t)msb * 100 + (int16_t)(lsb >> 6) * 25);
+}
+HAL_StatusTypeDef DS3231_ReadTemperatureCenti(int16_t *centi){
     uint8_t tb[2];
     HAL_StatusTypeDef st = ds_read(DS3231_REG_TEMP_MSB, tb, 2);
     if (st != HAL_OK) return st;
-    int8_t msb = (int8_t)tb[0];
-    uint8_t lsb = tb[1];
-    *temperature = (float)msb + ((float)(lsb >> 6) * 0.25f);
+    *centi = DS3231_TempRawToCenti(tb[0], tb[1]);
+    return HAL_OK;
+}
+#if DS3231_USE_FLOAT_TEMP
+HAL_StatusTypeDef DS3231_ReadTemperature(float *temperature){
+    int16_t c;
+    HAL_StatusTypeDef st = DS3231_ReadTemperatureCenti(&c);
+    if (st != HAL_OK) return st;
+    *temperature = (float)c * 0.01f;
+    return HAL_OK;
+}
+#endif
+
+/* Snapshot: whole map 0x00..0x12 in one transaction (time only if no temperature wanted) */
+HAL_StatusTypeDef DS3231_GetTimeTemp(DS3231_TimeTypeDef *time, int16_t *centi){
+    uint8_t buf[DS3231_REG_TEMP_LSB + 1];
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_SECONDS, buf, centi ? sizeof(buf) : 7);
+    if (st != HAL_OK) return st;
+    DS3231_DecodeTime(buf, time);
+    if (centi)
+        *centi = DS3231_TempRawToCenti(buf[DS3231_REG_TEMP_MSB], buf[DS3231_REG_TEMP_LSB]);
     return HAL_OK;
 }
 
@@ -89,10 +155,85 @@ HAL_StatusTypeDef DS3231_WriteControl(uint8_t val){ return ds_write(DS3231_REG_C
 HAL_StatusTypeDef DS3231_ReadStatus(uint8_t *val){  return ds_read(DS3231_REG_STATUS,  val, 1); }
 HAL_StatusTypeDef DS3231_WriteStatus(uint8_t val){  return ds_write(DS3231_REG_STATUS, &val, 1); }
 
+/* Alarms: bit7 of each register is the AxMy mask, bit6 of day/date is DY/DT */
+HAL_StatusTypeDef DS3231_SetAlarm1(const DS3231_AlarmTypeDef *alarm, DS3231_Alarm1Mode mode){
+    if (!alarm) return HAL_ERROR;
+    uint8_t buf[4];
+    buf[0]=DS3231_BIN2BCD(alarm->seconds);
+    buf[1]=DS3231_BIN2BCD(alarm->minutes);
+    buf[2]=DS3231_BIN2BCD(alarm->hours);   // 24h
+    buf[3]=DS3231_BIN2BCD(alarm->dayDate);
+    switch (mode){
+    case DS3231_A1_EVERY_SECOND:   buf[0] |= DS3231_ALARM_MASK_BIT; /* fall through */
+    case DS3231_A1_MATCH_S:        buf[1] |= DS3231_ALARM_MASK_BIT; /* fall through */
+    case DS3231_A1_MATCH_MS:       buf[2] |= DS3231_ALARM_MASK_BIT; /* fall through */
+    case DS3231_A1_MATCH_HMS:      buf[3] |= DS3231_ALARM_MASK_BIT; break;
+    case DS3231_A1_MATCH_DATE_HMS: break;
+    case DS3231_A1_MATCH_DAY_HMS:  buf[3] |= DS3231_ALARM_DYDT; break;
+    default: return HAL_ERROR;
+    }
+    return ds_write(DS3231_REG_ALARM1, buf, 4);
+}
+HAL_StatusTypeDef DS3231_SetAlarm2(const DS3231_AlarmTypeDef *alarm, DS3231_Alarm2Mode mode){
+    if (!alarm) return HAL_ERROR;
+    uint8_t buf[3];
+    buf[0]=DS3231_BIN2BCD(alarm->minutes);
+    buf[1]=DS3231_BIN2BCD(alarm->hours);
+    buf[2]=DS3231_BIN2BCD(alarm->dayDate);
+    switch (mode){
+    case DS3231_A2_EVERY_MINUTE:  buf[0] |= DS3231_ALARM_MASK_BIT; /* fall through */
+    case DS3231_A2_MATCH_M:       buf[1] |= DS3231_ALARM_MASK_BIT; /* fall through */
+    case DS3231_A2_MATCH_HM:      buf[2] |= DS3231_ALARM_MASK_BIT; break;
+    case DS3231_A2_MATCH_DATE_HM: break;
+    case DS3231_A2_MATCH_DAY_HM:  buf[2] |= DS3231_ALARM_DYDT; break;
+    default: return HAL_ERROR;
+    }
+    return ds_write(DS3231_REG_ALARM2, buf, 3);
+}
+HAL_StatusTypeDef DS3231_EnableAlarmInt(uint8_t alarms){
+    uint8_t ctrl;
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_CONTROL, &ctrl, 1);
+    if (st != HAL_OK) return st;
+    ctrl |= DS3231_CONTROL_INTCN;             // INT/SQW becomes the alarm output
+    ctrl |= (uint8_t)(alarms & (DS3231_CONTROL_A1IE | DS3231_CONTROL_A2IE));
+    return ds_write(DS3231_REG_CONTROL, &ctrl, 1);
+}
+HAL_StatusTypeDef DS3231_DisableAlarmInt(uint8_t alarms){
+    uint8_t ctrl;
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_CONTROL, &ctrl, 1);
+    if (st != HAL_OK) return st;
+    ctrl &= (uint8_t)~(alarms & (DS3231_CONTROL_A1IE | DS3231_CONTROL_A2IE));
+    return ds_write(DS3231_REG_CONTROL, &ctrl, 1);
+}
+HAL_StatusTypeDef DS3231_CheckAlarms(uint8_t *fired){
+    uint8_t stat;
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_STATUS, &stat, 1);
+    if (st != HAL_OK) return st;
+    uint8_t f = (uint8_t)(stat & (DS3231_STATUS_A1F | DS3231_STATUS_A2F));
+    if (fired) *fired = f;
+    if (!f) return HAL_OK;
+    stat &= (uint8_t)~f;
+    return ds_write(DS3231_REG_STATUS, &stat, 1);
+}
+
+/* Aging offset */
+HAL_StatusTypeDef DS3231_ReadAging(int8_t *aging){ return ds_read(DS3231_REG_AGING, (uint8_t*)aging, 1); }
+HAL_StatusTypeDef DS3231_WriteAging(int8_t aging){
+    uint8_t v = (uint8_t)aging;
+    return ds_write(DS3231_REG_AGING, &v, 1);
+}
+HAL_StatusTypeDef DS3231_StartConversion(void){
+    uint8_t ctrl;
+    HAL_StatusTypeDef st = ds_read(DS3231_REG_CONTROL, &ctrl, 1);
+    if (st != HAL_OK) return st;
+    ctrl |= DS3231_CONTROL_CONV;
+    return ds_write(DS3231_REG_CONTROL, &ctrl, 1);
+}
+
 /* NEW in v3: one-shot initializer based on OSF bit */
 HAL_StatusTypeDef DS3231_EnsureInitialized(const DS3231_TimeTypeDef *default_time){
     HAL_StatusTypeDef st;
-    uint8_t stat=0, ctrl=0;
+    uint8_t stat=0, ctrl=0, wroteTime=0;
 
     st = DS3231_ReadStatus(&stat);
     if (st != HAL_OK) return st;
@@ -112,6 +253,7 @@ HAL_StatusTypeDef DS3231_EnsureInitialized(const DS3231_TimeTypeDef *default_tim
             DS3231_TimeTypeDef tmp = *default_time;
             st = DS3231_SetTime(&tmp);
             if (st != HAL_OK) return st;
+            wroteTime = 1;
         }
 
         /* Clear OSF so we don't re-init next boot */
@@ -120,5 +262,98 @@ HAL_StatusTypeDef DS3231_EnsureInitialized(const DS3231_TimeTypeDef *default_tim
         if (st != HAL_OK) return st;
     }
 
-    return HAL_OK;
+    /* Time kept from before (maybe set elsewhere with another weekday convention):
+     * Alarm 1 DAY matching compares the DY register, so align it with the derived weekday */
+    if (!wroteTime){
+        uint8_t buf[7];
+        st = ds_read(DS3231_REG_SECONDS, buf, 7);
+        if (st != HAL_OK) return st;
+        uint8_t dy = ds_derivedDay(buf);
+        if ((buf[3] & 0x07) != dy) st = ds_write(DS3231_REG_DAY, &dy, 1);
+    }
+    return st;
+}
+
+/* Non-blocking EnsureInitialized: same steps as above, chained through I2C engine callbacks */
+enum { EI_STATUS, EI_CONTROL_RD, EI_CONTROL_WR, EI_TIME_WR, EI_STATUS_WR, EI_DAY_RD, EI_DAY_WR };
+static uint8_t             s_eiStep;
+static uint8_t             s_eiBuf[1];
+static uint8_t             s_eiTime[7];
+static uint8_t             s_eiStat;
+static uint8_t             s_eiHasTime;
+static DS3231_DoneCallback s_eiCb = NULL;
+static uint8_t             s_eiBusy = 0;
+
+static void ds_eiNext(HAL_StatusTypeDef st, void *ctx);
+
+static HAL_StatusTypeDef ds_eiSubmit(uint8_t dir, uint8_t reg, uint8_t *p, uint16_t n){
+    I2CEng_Req r = { DS3231_I2C_ADDR, reg, dir, p, n, DS3231_I2C_TIMEOUT_MS, ds_eiNext, NULL };
+    return I2CEng_Submit(&r);
+}
+
+static void ds_eiDone(HAL_StatusTypeDef st){
+    s_eiBusy = 0;
+    if (s_eiCb) s_eiCb(st);
+}
+
+static HAL_StatusTypeDef ds_eiDayCheck(void){
+    s_eiStep = EI_DAY_RD;
+    return ds_eiSubmit(I2CENG_READ, DS3231_REG_SECONDS, s_eiTime, 7);
+}
+
+static void ds_eiNext(HAL_StatusTypeDef st, void *ctx){
+    (void)ctx;
+    if (st != HAL_OK){ ds_eiDone(st); return; }
+    switch (s_eiStep){
+    case EI_STATUS:
+        s_eiStat = s_eiBuf[0];
+        if (!(s_eiStat & DS3231_STATUS_OSF)){ st = ds_eiDayCheck(); break; }
+        s_eiStep = EI_CONTROL_RD;
+        st = ds_eiSubmit(I2CENG_READ, DS3231_REG_CONTROL, s_eiBuf, 1);
+        break;
+    case EI_CONTROL_RD:
+        s_eiBuf[0] &= (uint8_t)~(DS3231_CONTROL_EOSC | DS3231_CONTROL_INTCN | DS3231_CONTROL_RS_MASK);
+        s_eiStep = EI_CONTROL_WR;
+        st = ds_eiSubmit(I2CENG_WRITE, DS3231_REG_CONTROL, s_eiBuf, 1);
+        break;
+    case EI_CONTROL_WR:
+        if (s_eiHasTime){
+            s_eiStep = EI_TIME_WR;
+            st = ds_eiSubmit(I2CENG_WRITE, DS3231_REG_SECONDS, s_eiTime, 7);
+            break;
+        }
+        /* fall through */
+    case EI_TIME_WR:
+        s_eiStat &= (uint8_t)~DS3231_STATUS_OSF;
+        s_eiStep = EI_STATUS_WR;
+        st = ds_eiSubmit(I2CENG_WRITE, DS3231_REG_STATUS, &s_eiStat, 1);
+        break;
+    case EI_STATUS_WR:
+        if (!s_eiHasTime){ st = ds_eiDayCheck(); break; }
+        ds_eiDone(HAL_OK);
+        return;
+    case EI_DAY_RD:
+        s_eiBuf[0] = ds_derivedDay(s_eiTime);
+        if ((s_eiTime[3] & 0x07) == s_eiBuf[0]){ ds_eiDone(HAL_OK); return; }
+        s_eiStep = EI_DAY_WR;
+        st = ds_eiSubmit(I2CENG_WRITE, DS3231_REG_DAY, s_eiBuf, 1);
+        break;
+    default:
+        ds_eiDone(HAL_OK);
+        return;
+    }
+    if (st != HAL_OK) ds_eiDone(st);
+}
+
+HAL_StatusTypeDef DS3231_EnsureInitializedAsync(const DS3231_TimeTypeDef *default_time, DS3231_DoneCallback cb){
+    if (!hI2C) return HAL_ERROR;
+    if (s_eiBusy) return HAL_BUSY;
+    s_eiHasTime = (default_time != NULL);
+    if (s_eiHasTime) ds_encodeTime(default_time, s_eiTime);
+    s_eiCb = cb;
+    s_eiStep = EI_STATUS;
+    s_eiBusy = 1;
+    HAL_StatusTypeDef st = ds_eiSubmit(I2CENG_READ, DS3231_REG_STATUS, s_eiBuf, 1);
+    if (st != HAL_OK) s_eiBusy = 0;
+    return st;
 }
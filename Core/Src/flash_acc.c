@@ -0,0 +1,107 @@
+
+/*
+ * flash_acc.c  (STM32C0xx-ready)
+ *
+ * Implementation of the flash accelerator profiles (see flash_acc.h)
+ */
+
+#include "flash_acc.h"
+#include "prof.h"
+#include "ta6932.h"
+#include "ds3231_time.h"
+
+FlashAcc_Profile FlashAcc_ForClock(uint32_t hclk_hz){
+    FlashAcc_Profile p;
+    p.icache = 1;
+    if (hclk_hz <= FLASHACC_0WS_MAX_HZ){
+        p.latency  = FLASH_LATENCY_0;
+        p.prefetch = 0;
+    } else {
+        p.latency  = FLASH_LATENCY_1;
+        p.prefetch = 1;
+    }
+    return p;
+}
+
+HAL_StatusTypeDef FlashAcc_Apply(const FlashAcc_Profile *p, uint32_t hclk_hz){
+    if (!p) return HAL_ERROR;
+    if (hclk_hz > FLASHACC_0WS_MAX_HZ && p->latency == FLASH_LATENCY_0) return HAL_ERROR;
+
+    __HAL_FLASH_SET_LATENCY(p->latency);
+    if (__HAL_FLASH_GET_LATENCY() != p->latency) return HAL_ERROR;
+
+    if (p->prefetch) __HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+    else             __HAL_FLASH_PREFETCH_BUFFER_DISABLE();
+
+    if (p->icache){
+        __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+    } else {
+        /* reset while disabled so a later enable starts from a clean cache */
+        __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+        __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef FlashAcc_ApplyForClock(uint32_t hclk_hz){
+    FlashAcc_Profile p = FlashAcc_ForClock(hclk_hz);
+    return FlashAcc_Apply(&p, hclk_hz);
+}
+
+void FlashAcc_Get(FlashAcc_Profile *p){
+    if (!p) return;
+    p->latency  = __HAL_FLASH_GET_LATENCY();
+    p->prefetch = (FLASH->ACR & FLASH_ACR_PRFTEN) ? 1 : 0;
+    p->icache   = (FLASH->ACR & FLASH_ACR_ICEN)   ? 1 : 0;
+}
+
+// ===== Benchmark =====
+
+static const uint8_t s_copySrc[64] = {
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+    16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+    32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47,
+    48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63
+};
+static volatile uint32_t s_sink;   // keeps the workloads from being optimised out
+
+static void bench_run(FlashAcc_Workload w, uint16_t i){
+    switch (w){
+    case FLASHACC_WL_RENDER:
+        TA6932_putTemperature(0, (int16_t)((int16_t)i * 7 - 1000));
+        TA6932_putDigit(4, i & 7, 0);
+        TA6932_putDigit(5, (i >> 3) & 7, 1);
+        break;
+    case FLASHACC_WL_CALENDAR: {
+        DS3231_TimeTypeDef t;
+        DS3231_FromEpoch(DS3231_EPOCH_2000 + (uint32_t)i * 86461UL, &t);
+        s_sink = t.seconds + t.date;
+        break;
+    }
+    case FLASHACC_WL_COPY: {
+        uint8_t dst[64];
+        for (uint8_t k = 0; k < sizeof dst; k++) dst[k] = s_copySrc[k] ^ (uint8_t)i;
+        s_sink = dst[i & 63];
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+uint32_t FlashAcc_Bench(const FlashAcc_Profile *p, FlashAcc_Workload w, uint16_t iters){
+    FlashAcc_Profile saved;
+    uint32_t t0, cycles;
+
+    if (iters == 0 || w >= FLASHACC_WL_COUNT) return 0;
+    FlashAcc_Get(&saved);
+    if (FlashAcc_Apply(p, HAL_RCC_GetHCLKFreq()) != HAL_OK) return 0;
+
+    bench_run(w, 0);                        // warm-up: same cache state for every profile
+    t0 = PROF_Stamp();
+    for (uint16_t i = 0; i < iters; i++) bench_run(w, i);
+    cycles = PROF_Cycles(t0);
+
+    FlashAcc_Apply(&saved, HAL_RCC_GetHCLKFreq());
+    return cycles / iters;
+}
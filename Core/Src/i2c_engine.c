@@ -0,0 +1,269 @@
+
+/*
+ * i2c_engine.c  (STM32C0xx-ready)
+ *
+ * Implementation of the interrupt-driven I2C transaction engine (see i2c_engine.h)
+ */
+
+#include "i2c_engine.h"
+#include "prof.h"
+
+static I2C_HandleTypeDef *s_h = NULL;
+
+static I2CEng_Req s_q[I2CENG_QUEUE_LEN];
+static uint8_t  s_tries[I2CENG_QUEUE_LEN];   // attempts already made per queued request
+static uint8_t  s_qHead = 0, s_qCount = 0;
+
+static uint8_t  s_running = 0;        // s_q[s_qHead] is on the bus
+static uint32_t s_start = 0;
+static volatile uint8_t s_irqDone = 0;
+static volatile HAL_StatusTypeDef s_irqStatus = HAL_OK;
+static volatile uint32_t s_irqErr = HAL_I2C_ERROR_NONE;
+
+static uint32_t s_worstBlock = 0;
+
+static I2CEng_BusHook s_hook = NULL;
+static uint8_t  s_owned = 0;          // hook told to step aside
+
+/* Health layer */
+static I2CEng_Health s_dev[I2CENG_MAX_DEVICES];
+static uint32_t s_recoveries = 0;
+static uint32_t s_total[7];           // ok, nack, arlo, berr, timeout, retry, skipped (telemetry)
+enum { T_OK, T_NACK, T_ARLO, T_BERR, T_TIMEOUT, T_RETRY, T_SKIPPED };
+
+static I2CEng_Health *eng_dev(uint16_t dev){
+    I2CEng_Health *fresh = NULL;
+    for (uint8_t i = 0; i < I2CENG_MAX_DEVICES; i++){
+        if (s_dev[i].dev == dev) return &s_dev[i];
+        if (!s_dev[i].dev && !fresh) fresh = &s_dev[i];
+    }
+    if (fresh) fresh->dev = dev;
+    return fresh;                      // NULL if the table is full: not tracked
+}
+
+void I2CEng_Init(I2C_HandleTypeDef *hi2c){
+    if (s_h == hi2c) return;
+    s_h = hi2c;
+    s_qHead = 0;
+    s_qCount = 0;
+    s_running = 0;
+    s_irqDone = 0;
+
+    PROF_Register("i2c.ok",        &s_total[T_OK]);
+    PROF_Register("i2c.nack",      &s_total[T_NACK]);
+    PROF_Register("i2c.arlo",      &s_total[T_ARLO]);
+    PROF_Register("i2c.berr",      &s_total[T_BERR]);
+    PROF_Register("i2c.timeout",   &s_total[T_TIMEOUT]);
+    PROF_Register("i2c.retry",     &s_total[T_RETRY]);
+    PROF_Register("i2c.skipped",   &s_total[T_SKIPPED]);
+    PROF_Register("i2c.recover",   &s_recoveries);
+    PROF_Register("i2c.worst_cyc", &s_worstBlock);
+}
+
+HAL_StatusTypeDef I2CEng_Submit(const I2CEng_Req *req){
+    if (!s_h || !req || !req->buf || !req->len) return HAL_ERROR;
+    if (s_qCount >= I2CENG_QUEUE_LEN) return HAL_BUSY;
+    I2CEng_Health *h = eng_dev(req->dev);
+    if (h && h->fails && (int32_t)(HAL_GetTick() - h->holdUntil) < 0){
+        h->skipped++;
+        s_total[T_SKIPPED]++;
+        return HAL_BUSY;               // backing off: don't touch the bus
+    }
+    uint8_t slot = (uint8_t)((s_qHead + s_qCount) % I2CENG_QUEUE_LEN);
+    s_q[slot] = *req;
+    s_tries[slot] = 0;
+    s_qCount++;
+    I2CEng_Task();                     // start right away if the bus is idle
+    return HAL_OK;
+}
+
+void I2CEng_SetBusHook(I2CEng_BusHook hook){ s_hook = hook; }
+
+uint8_t I2CEng_Busy(void){ return (uint8_t)(s_qCount != 0); }
+
+/* ~5 us half period for 100 kHz-ish recovery clocks */
+static void eng_halfBit(void){
+    for (volatile uint32_t n = SystemCoreClock / 1000000UL; n; n--) { }
+}
+
+void I2CEng_Recover(void){
+    GPIO_InitTypeDef g = {0};
+    if (!s_h) return;
+    s_recoveries++;
+
+    HAL_I2C_DeInit(s_h);               // also releases the pins (MspDeInit)
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    HAL_GPIO_WritePin(I2CENG_SCL_PORT, I2CENG_SCL_PIN, GPIO_PIN_SET);
+    HAL_GPIO_WritePin(I2CENG_SDA_PORT, I2CENG_SDA_PIN, GPIO_PIN_SET);
+    g.Mode  = GPIO_MODE_OUTPUT_OD;
+    g.Pull  = GPIO_NOPULL;
+    g.Speed = GPIO_SPEED_FREQ_LOW;
+    g.Pin   = I2CENG_SCL_PIN;
+    HAL_GPIO_Init(I2CENG_SCL_PORT, &g);
+    g.Pin   = I2CENG_SDA_PIN;
+    HAL_GPIO_Init(I2CENG_SDA_PORT, &g);
+
+    /* Clock out whatever byte a slave is still driving */
+    for (uint8_t i = 0; i < 9; i++){
+        if (HAL_GPIO_ReadPin(I2CENG_SDA_PORT, I2CENG_SDA_PIN) == GPIO_PIN_SET && i) break;
+        HAL_GPIO_WritePin(I2CENG_SCL_PORT, I2CENG_SCL_PIN, GPIO_PIN_RESET); eng_halfBit();
+        HAL_GPIO_WritePin(I2CENG_SCL_PORT, I2CENG_SCL_PIN, GPIO_PIN_SET);   eng_halfBit();
+    }
+    /* STOP: SDA low -> high while SCL high */
+    HAL_GPIO_WritePin(I2CENG_SDA_PORT, I2CENG_SDA_PIN, GPIO_PIN_RESET); eng_halfBit();
+    HAL_GPIO_WritePin(I2CENG_SCL_PORT, I2CENG_SCL_PIN, GPIO_PIN_SET);   eng_halfBit();
+    HAL_GPIO_WritePin(I2CENG_SDA_PORT, I2CENG_SDA_PIN, GPIO_PIN_SET);   eng_halfBit();
+
+    HAL_I2C_Init(s_h);                 // Init fields are kept in the handle; MspInit restores AF
+}
+
+/* Classifies the outcome, updates the device health. Returns 1 if worth retrying */
+static uint8_t eng_account(I2CEng_Health *h, HAL_StatusTypeDef st, uint32_t err){
+    uint8_t t;
+    if (st == HAL_OK)                         t = T_OK;
+    else if (st == HAL_TIMEOUT)               t = T_TIMEOUT;
+    else if (err & HAL_I2C_ERROR_AF)          t = T_NACK;
+    else if (err & HAL_I2C_ERROR_ARLO)        t = T_ARLO;
+    else                                      t = T_BERR;
+    s_total[t]++;
+    if (h){
+        switch (t){
+        case T_OK:      h->ok++;      break;
+        case T_TIMEOUT: h->timeout++; break;
+        case T_NACK:    h->nack++;    break;
+        case T_ARLO:    h->arlo++;    break;
+        default:        h->berr++;    break;
+        }
+    }
+    return (uint8_t)(t == T_ARLO || t == T_BERR || t == T_TIMEOUT);
+}
+
+static void eng_backoff(I2CEng_Health *h, HAL_StatusTypeDef st){
+    if (!h) return;
+    if (st == HAL_OK){ h->fails = 0; return; }
+    if (h->fails < 255) h->fails++;
+    uint32_t ms = I2CENG_BACKOFF_MAX_MS;
+    if (h->fails <= 16){
+        ms = (uint32_t)I2CENG_BACKOFF_BASE_MS << (h->fails - 1);
+        if (ms > I2CENG_BACKOFF_MAX_MS) ms = I2CENG_BACKOFF_MAX_MS;
+    }
+    h->holdUntil = HAL_GetTick() + ms;
+}
+
+static void eng_finish(HAL_StatusTypeDef st, uint32_t err){
+    I2CEng_Health *h = eng_dev(s_q[s_qHead].dev);
+    uint8_t retry = eng_account(h, st, err);
+    s_running = 0;
+    if (st != HAL_OK && retry && s_tries[s_qHead] < I2CENG_RETRIES){
+        s_tries[s_qHead]++;            // stays at the head, restarted by I2CEng_Task()
+        if (h) h->retry++;
+        s_total[T_RETRY]++;
+        return;
+    }
+    eng_backoff(h, st);
+
+    I2CEng_Req r = s_q[s_qHead];
+    s_qHead = (uint8_t)((s_qHead + 1) % I2CENG_QUEUE_LEN);
+    s_qCount--;
+    if (r.cb) r.cb(st, r.ctx);
+    if (!s_qCount && s_owned){
+        s_owned = 0;
+        if (s_hook) s_hook(0);         // may queue again (re-acquires in eng_start)
+    }
+}
+
+static void eng_start(void){
+    const I2CEng_Req *r = &s_q[s_qHead];
+    HAL_StatusTypeDef st;
+    if (!s_owned){
+        s_owned = 1;
+        if (s_hook) s_hook(1);
+    }
+    s_irqDone = 0;
+    s_irqErr = HAL_I2C_ERROR_NONE;
+    if (r->dir == I2CENG_WRITE)
+        st = HAL_I2C_Mem_Write_IT(s_h, r->dev, r->reg, I2C_MEMADD_SIZE_8BIT, r->buf, r->len);
+    else
+        st = HAL_I2C_Mem_Read_IT(s_h, r->dev, r->reg, I2C_MEMADD_SIZE_8BIT, r->buf, r->len);
+    if (st != HAL_OK){
+        if (st == HAL_BUSY) I2CEng_Recover();   // bus held low by someone
+        eng_finish(st, HAL_I2C_GetError(s_h));
+        return;
+    }
+    s_running = 1;
+    s_start = HAL_GetTick();
+}
+
+void I2CEng_Task(void){
+    if (!s_h) return;
+    if (s_running){
+        if (s_irqDone){
+            eng_finish(s_irqStatus, s_irqErr);
+        } else if ((HAL_GetTick() - s_start) >= s_q[s_qHead].timeout_ms){
+            I2CEng_Recover();
+            eng_finish(HAL_TIMEOUT, HAL_I2C_ERROR_TIMEOUT);
+        }
+    }
+    if (!s_running && s_qCount) eng_start();
+}
+
+/* ===== Blocking helper ===== */
+typedef struct {
+    volatile uint8_t done;
+    HAL_StatusTypeDef st;
+} eng_wait_t;
+
+static void eng_waitCb(HAL_StatusTypeDef st, void *ctx){
+    eng_wait_t *w = (eng_wait_t*)ctx;
+    w->st = st;
+    w->done = 1;
+}
+
+HAL_StatusTypeDef I2CEng_Transfer(const I2CEng_Req *req){
+    eng_wait_t w = { 0, HAL_ERROR };
+    I2CEng_Req r = *req;
+    r.cb = eng_waitCb;
+    r.ctx = &w;
+
+    uint32_t t0 = PROF_Stamp();
+    HAL_StatusTypeDef st = I2CEng_Submit(&r);
+    if (st != HAL_OK) return st;
+    while (!w.done) I2CEng_Task();
+    uint32_t c = PROF_Cycles(t0);
+    if (c > s_worstBlock) s_worstBlock = c;
+
+    if (req->cb) req->cb(w.st, req->ctx);
+    return w.st;
+}
+
+uint32_t I2CEng_WorstBlockCycles(void){ return s_worstBlock; }
+
+const I2CEng_Health *I2CEng_GetHealth(uint16_t dev){
+    for (uint8_t i = 0; i < I2CENG_MAX_DEVICES; i++)
+        if (s_dev[i].dev == dev) return &s_dev[i];
+    return NULL;
+}
+
+void I2CEng_ResetBackoff(uint16_t dev){
+    for (uint8_t i = 0; i < I2CENG_MAX_DEVICES; i++)
+        if (s_dev[i].dev == dev) s_dev[i].fails = 0;
+}
+
+/* ===== HAL callbacks (interrupt context) ===== */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c){
+    if (hi2c != s_h) return;
+    s_irqStatus = HAL_OK;
+    s_irqDone = 1;
+}
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c){
+    if (hi2c != s_h) return;
+    s_irqStatus = HAL_OK;
+    s_irqDone = 1;
+}
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c){
+    if (hi2c != s_h) return;
+    s_irqErr = HAL_I2C_GetError(hi2c);
+    s_irqStatus = HAL_ERROR;
+    s_irqDone = 1;
+}
@@ -22,6 +22,16 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include"ta6932.h"
+#include "ta6932_fade.h"
+#include "ds3231_v3.h"
+#include "autobright.h"
+#include "alarm_sched.h"
+#include "ds3231_cal.h"
+#include "ds3231_time.h"
+#include "boot.h"
+#include "flash_acc.h"
+#include "clk_gov.h"
+#include "ta6932_link.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -31,6 +41,10 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define APP_RUN_DEMO  0   // 1 => run the TA6932 demo sequence at boot (~15 s of HAL_Delay)
+/* >0 => open a DS3231 aging-trim window of this many seconds at boot. The reference is the
+   HAL tick, i.e. HSI48 (~1 %): only enable it with an accurate clock source on the board. */
+#define APP_RTCCAL_WINDOW_S  0
 
 /* USER CODE END PD */
 
@@ -40,10 +54,14 @@
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
+I2C_HandleTypeDef hi2c1;
 
 SPI_HandleTypeDef hspi1;
 
 /* USER CODE BEGIN PV */
+static volatile uint8_t rtcMinute = 1;   // set by DS3231 Alarm 2 (once per minute), 1 => snapshot at boot
+static volatile uint8_t rtcReady = 0;    // DS3231 bring-up finished (any status)
+static const DS3231_TimeTypeDef rtcDefault = { 0, 0, 0, 0, 1, 1, 2025 };
 
 /* USER CODE END PV */
 
@@ -51,7 +69,11 @@ SPI_HandleTypeDef hspi1;
 void SystemClock_Config(void);
 static void MX_GPIO_Init(void);
 static void MX_SPI1_Init(void);
+static void MX_I2C1_Init(void);
 /* USER CODE BEGIN PFP */
+static void RTC_OnMinute(uint8_t id);
+static void RTC_OnReady(HAL_StatusTypeDef status);
+static uint32_t RTC_RefNow(void);
 
 /* USER CODE END PFP */
 
@@ -67,7 +89,7 @@ static void MX_SPI1_Init(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-
+  BOOT_CaptureReset();
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -76,21 +98,39 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
-
+  BOOT_Mark("hal");
   /* USER CODE END Init */
 
   /* Configure the system clock */
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  FlashAcc_ApplyForClock(HAL_RCC_GetHCLKFreq()); // prefetch + cache for 1 WS at 48 MHz
+  BOOT_Mark("clock");
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
   MX_SPI1_Init();
+  MX_I2C1_Init();
   /* USER CODE BEGIN 2 */
+  ClkGov_Init(&hspi1, &hi2c1);
+  (void)TA6932_LinkLoad();           // SPI rate found by TA6932_LinkSweep(), if any
+  BOOT_Mark("periph");
+
+  /* First frame before anything slow: "--:--" (replaced by the time on the first minute snapshot;
+     the dp on digit 1 stays as the HH:MM colon) */
   TA6932_Init();
+  for (counter = 0; counter < 4; counter++) TA6932_putChar(counter, '-', counter == 1);
+  TA6932_WriteAll();
+  BOOT_Mark("frame");
+
+  /* RTC bring-up runs on the I2C engine while the rest of the init continues */
+  DS3231_Init(&hi2c1);
+  if (DS3231_EnsureInitializedAsync(&rtcDefault, RTC_OnReady) != HAL_OK) rtcReady = 1;
+  BOOT_Mark("rtc queued");
+
+#if APP_RUN_DEMO
   TA6932_Clear();                    // يمسح ويكتب
  HAL_Delay(1000);
  //goto Test_2;
@@ -101,11 +141,11 @@ int main(void)
  HAL_Delay(1000);
  TA6932_DisplayOn();   //OFF display
 
- while(counter<7)// Brightness
+ TA6932_SetLevel(0);
+ TA6932_FadeTo(255, 1400, NULL); // Brightness fade-in (gamma + dithering)
+ while(TA6932_FadeBusy())
  {
-	 TA6932_SetBrightness(counter) ;
- counter++;
- HAL_Delay(200);
+	 TA6932_FadeTask();
  };
 
  TA6932_Clear();
@@ -145,14 +185,33 @@ for(counter=0;counter<16;counter++)
  HAL_Delay(200);
 }
 //=========================================================================Write buffer
-//                 1      A     b   c     d  Blank  1     2      3
-uint8_t digit []={0x21, 0x6F,0x7A,0x58,0x79,0,0,0,0x21, 0x5D, 0x75 };
+//                1           A                         b                         c
+uint8_t digit []={TA_GLYPH_1, TA_GLYPH(1,1,1,0,1,1,1), TA_GLYPH(0,0,1,1,1,1,1), TA_GLYPH(0,0,0,1,1,0,1),
+                  TA_GLYPH(0,1,1,1,1,0,1), 0,0,0, TA_GLYPH_1, TA_GLYPH_2, TA_GLYPH_3 };  // d, Blank, 1, 2, 3
 TA6932_loadBuffer(digit);
 TA6932_WriteAll();
 //=========================================================================
+#endif /* APP_RUN_DEMO */
 
 
 
+  AutoBright_Init(NULL, 0);
+  AutoBright_SetThermal(1, 4500, 16, AUTOBRIGHT_LEVEL_DIM);
+  BOOT_Mark("app");
+
+  while (!rtcReady) I2CEng_Task();   // bounded by the per-transfer deadlines
+  BOOT_Mark("rtc ready");
+
+  AlarmSched_SetMinuteCallback(RTC_OnMinute);
+  (void)AlarmSched_Start();
+  {
+    static const RtcCal_Port calPort = { RTC_RefNow, 1000, NULL, NULL, NULL, NULL };
+    RtcCal_Init(&calPort);
+  }
+#if APP_RTCCAL_WINDOW_S > 0
+  (void)RtcCal_Start(APP_RTCCAL_WINDOW_S);  // alarms pause until RtcCal_Task() reports the window done
+#endif
+  BOOT_Mark("alarms");
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -162,6 +221,67 @@ TA6932_WriteAll();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
+    /* Bursty work queued: full speed before touching the buses */
+    if (AlarmSched_Pending() || rtcMinute || TA6932_FadeNeedsTick() || I2CEng_Busy())
+    {
+      (void)ClkGov_Boost();
+    }
+    AlarmSched_Task();
+    if (RtcCal_Task())                  // calibration window done: back to alarm mode
+    {
+      (void)AlarmSched_Start();
+    }
+    if (rtcMinute)
+    {
+      DS3231_TimeTypeDef now;
+      uint8_t raw[7];
+      int16_t temp = 0;
+      uint8_t changed;
+      rtcMinute = 0;
+      /* Time read on every edge: edges can merge while AlarmSched_Task retries,
+         so counting them would lose whole minutes */
+      if (DS3231_GetTimeRaw(raw) == HAL_OK)
+      {
+        changed = TA6932_RenderClockBCD(raw);   // only the fields that changed, dp bits kept
+        if (changed & 0x01)                     // seconds are not ticked between edges: keep them dark
+        {
+          TA6932_putRaw(TA6932_CLK_ADDR_SS, 0x00);
+          TA6932_putRaw(TA6932_CLK_ADDR_SS + 1, 0x00);
+        }
+        if (changed) TA6932_WriteAll();
+        DS3231_DecodeTime(raw, &now);
+        RtcCal_ClockSync(DS3231_ToEpoch(&now));  // RtcCal_ClockNow() between edges
+        if (!AutoBright_WantsTemperature() || DS3231_ReadTemperatureCenti(&temp) == HAL_OK)
+        {
+          AutoBright_OnSnapshot(&now, temp);
+        }
+      }
+    }
+    TA6932_FadeTask();
+    (void)TA6932_BlinkTask();           // sends only when a blink phase changes what is lit
+
+    /* Nothing to do until the next DS3231 INT edge: sleep with SysTick stopped */
+    if (!AlarmSched_Pending() && !rtcMinute && !TA6932_FadeNeedsTick() && !I2CEng_Busy())
+    {
+      if (!RtcCal_Active()) (void)ClkGov_Idle();  // calibration times SQW against the core clock
+      /* Re-check with IRQs masked: an INT edge landing after the check still leaves its
+       * interrupt pending, which wakes WFI (INT stays low until serviced, so no second edge). */
+      __disable_irq();
+      if (!AlarmSched_Pending() && !rtcMinute && !I2CEng_Busy())
+      {
+        if (TA6932_BlinkActive() || RtcCal_Active())  // blink phases / calibration reference run on the 1 ms tick
+        {
+          HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+        }
+        else
+        {
+          HAL_SuspendTick();
+          HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+          HAL_ResumeTick();
+        }
+      }
+      __enable_irq();
+    }
   }
   /* USER CODE END 3 */
 }
@@ -202,6 +322,54 @@ void SystemClock_Config(void)
   }
 }
 
+/**
+  * @brief I2C1 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_I2C1_Init(void)
+{
+
+  /* USER CODE BEGIN I2C1_Init 0 */
+
+  /* USER CODE END I2C1_Init 0 */
+
+  /* USER CODE BEGIN I2C1_Init 1 */
+
+  /* USER CODE END I2C1_Init 1 */
+  hi2c1.Instance = I2C1;
+  hi2c1.Init.Timing = 0x20303E5D;
+  hi2c1.Init.OwnAddress1 = 0;
+  hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+  hi2c1.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+  hi2c1.Init.OwnAddress2 = 0;
+  hi2c1.Init.OwnAddress2Masks = I2C_OA2_NOMASK;
+  hi2c1.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+  hi2c1.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+  if (HAL_I2C_Init(&hi2c1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Configure Analogue filter
+  */
+  if (HAL_I2CEx_ConfigAnalogFilter(&hi2c1, I2C_ANALOGFILTER_ENABLE) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Configure Digital filter
+  */
+  if (HAL_I2CEx_ConfigDigitalFilter(&hi2c1, 0) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN I2C1_Init 2 */
+
+  /* USER CODE END I2C1_Init 2 */
+
+}
+
 /**
   * @brief SPI1 Initialization Function
   * @param None
@@ -268,10 +436,51 @@ static void MX_GPIO_Init(void)
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
 /* USER CODE BEGIN MX_GPIO_Init_2 */
+  /*Configure GPIO pin : DS3231 INT/SQW (open-drain, active low) */
+  GPIO_InitStruct.Pin = DS3231_INT_PIN;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_FALLING;
+  GPIO_InitStruct.Pull = GPIO_PULLUP;
+  HAL_GPIO_Init(DS3231_INT_PORT, &GPIO_InitStruct);
+
+  /* EXTI interrupt init*/
+  HAL_NVIC_SetPriority(EXTI0_1_IRQn, 2, 0);
+  HAL_NVIC_EnableIRQ(EXTI0_1_IRQn);
 /* USER CODE END MX_GPIO_Init_2 */
 }
 
 /* USER CODE BEGIN 4 */
+static void RTC_OnMinute(uint8_t id)
+{
+  (void)id;
+  rtcMinute = 1;
+}
+
+/* Calibration reference: the 1 ms HAL tick (kept at 1 ms by the clock governor) */
+static uint32_t RTC_RefNow(void)
+{
+  return HAL_GetTick();
+}
+
+static void RTC_OnReady(HAL_StatusTypeDef status)
+{
+  (void)status;
+  rtcReady = 1;
+}
+
+void HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin)
+{
+  if (GPIO_Pin == DS3231_INT_PIN)
+  {
+    if (RtcCal_Active())                // INT/SQW runs as 1 Hz SQW while calibrating
+    {
+      RtcCal_OnSqwEdge();
+    }
+    else
+    {
+      AlarmSched_OnIrq();
+    }
+  }
+}
 
 /* USER CODE END 4 */
 
@@ -10,6 +10,8 @@
 #include "stm32c0xx_hal.h"
 #include "main.h"
 #include "ds3231_v2.h"
+#define TA6932_WIRING TA6932_WIRING_STD
+#include "ta6932_font.h"
 
 /* Externs generated by CubeMX for STM32C0xx */
 extern I2C_HandleTypeDef hi2c1;
@@ -44,8 +46,10 @@ static void TA6932_DisplayOn(uint8_t level){
     TA6932_SendCommand(0x88 | level);
 }
 
+/* Standard a..g wiring on this board variant (0x3F,0x06,0x5B,...) */
 static const uint8_t segFont[10] = {
-    0x3F,0x06,0x5B,0x4F,0x66,0x6D,0x7D,0x07,0x7F,0x6F
+    TA_GLYPH_0, TA_GLYPH_1, TA_GLYPH_2, TA_GLYPH_3, TA_GLYPH_4,
+    TA_GLYPH_5, TA_GLYPH_6, TA_GLYPH_7, TA_GLYPH_8, TA_GLYPH_9
 };
 
 static uint8_t makeDigit(uint8_t d, uint8_t dp){
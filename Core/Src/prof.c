@@ -0,0 +1,51 @@
+
+/*
+ * prof.c  (STM32C0xx-ready)
+ *
+ * Implementation of the SysTick-based cycle profiler (see prof.h)
+ */
+
+#include "prof.h"
+
+uint32_t PROF_Stamp(void){
+    uint32_t t1, t2, val;
+    uint32_t reload = SysTick->LOAD + 1u;
+    do {
+        t1  = HAL_GetTick();
+        val = SysTick->VAL;
+        t2  = HAL_GetTick();
+    } while (t1 != t2);  // retry if the tick interrupt fired in between
+    return t1 * reload + (reload - 1u - val);
+}
+
+uint32_t PROF_Cycles(uint32_t start){
+    return PROF_Stamp() - start;
+}
+
+uint32_t PROF_Overhead(void){
+    uint32_t s = PROF_Stamp();
+    return PROF_Cycles(s);
+}
+
+/* ===== Telemetry counters ===== */
+static PROF_Counter s_counters[PROF_MAX_COUNTERS];
+static uint8_t s_nCounters = 0;
+
+uint8_t PROF_Register(const char *name, const volatile uint32_t *value){
+    for (uint8_t i = 0; i < s_nCounters; i++)
+        if (s_counters[i].value == value) return 1;   // already registered
+    if (s_nCounters >= PROF_MAX_COUNTERS) return 0;
+    s_counters[s_nCounters].name = name;
+    s_counters[s_nCounters].value = value;
+    s_nCounters++;
+    return 1;
+}
+
+uint8_t PROF_CounterCount(void){ return s_nCounters; }
+
+uint8_t PROF_GetCounter(uint8_t index, const char **name, uint32_t *value){
+    if (index >= s_nCounters) return 0;
+    if (name)  *name = s_counters[index].name;
+    if (value) *value = *s_counters[index].value;
+    return 1;
+}
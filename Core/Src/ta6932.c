@@ -2,154 +2,389 @@
 // Version: 1.0
 //Date:25/9/2025
 // - يحافظ على الدوال السابقة (WriteAll/WriteOneRaw/...)
-// - يحتوي على font7seg + setGlyph
+// - يحتوي على font7seg (مُولَّد من ta6932_font.h) + setGlyph
 // - يضيف الدوال الموحّدة: TA_RAW(), TA6932_putOne(), TA6932_putOneBuf()
 
 #include "ta6932.h"
+#include "clk_gov.h"
+#include "prof.h"
+#include <string.h>
 
 // SPI handle المُنشأ من CubeMX (عدّل لو تستخدم SPI ثاني)
 extern SPI_HandleTypeDef hspi1;
 
 // ===== Low-level =====
-static inline void TA_STB(int v){
-  HAL_GPIO_WritePin(TA_STB_PORT, TA_STB_PIN, v ? GPIO_PIN_SET : GPIO_PIN_RESET);
+// المسار الساخن (ضخ البايتات + إرسال البافر + تحويل القيم لمقاطع) يُنفَّذ من RAM:
+// الفلاش يعمل بـ FLASH_LATENCY_1 على 48MHz فكل جلب تعليمة منه يدفع wait state.
+// ملاحظة: دالة RAM تستدعي فقط دوال RAM أو TA_INLINE (لا قفز للفلاش داخل الحلقة).
+// حلقة قصيرة ≥ TA_STB_GAP_LOOPS × TA_STB_LOOP_CYCLES دورة
+static TA_INLINE void TA_STB_gap(void){
+  for (volatile uint8_t i = TA_STB_GAP_LOOPS; i; i--) {}
 }
-static HAL_StatusTypeDef TA_sendByte(uint8_t b){
-  return HAL_SPI_Transmit(&hspi1, &b, 1, 10);
+static TA_INLINE void TA_STB(int v){
+  if (v){
+    TA_STB_gap();                            // t_CLK_STB: BSY ينتهي مع آخر حافة CLK
+#if TA6932_HW_STB
+    CLEAR_BIT(hspi1.Instance->CR1, SPI_CR1_SPE);   // NSS → HIGH
+#else
+    TA_STB_PORT->BSRR = TA_STB_PIN;          // بدل HAL_GPIO_WritePin (في الفلاش)
+#endif
+    TA_STB_gap();                            // PW_STB قبل أي أمر تالٍ
+  } else {
+#if TA6932_HW_STB
+    SET_BIT(hspi1.Instance->CR1, SPI_CR1_SPE);     // NSS → LOW
+#else
+    TA_STB_PORT->BRR  = TA_STB_PIN;
+#endif
+  }
+}
+
+// يضخ len بايت عبر SPI1 مباشرة على السجلات وينتظر انتهاء آخر نبضة ساعة
+static TA_RAMFUNC void TA_spiPump(const uint8_t *p, uint8_t len){
+  SPI_TypeDef *spi = hspi1.Instance;
+#if !TA6932_HW_STB
+  if ((spi->CR1 & SPI_CR1_SPE) == 0U) spi->CR1 |= SPI_CR1_SPE;
+#endif
+  while (len--){
+    while ((spi->SR & SPI_SR_TXE) == 0U) {}
+    *(__IO uint8_t *)&spi->DR = *p++;       // وصول 8-بت وإلا يُرسل بايتين من الـ FIFO
+  }
+  while ((spi->SR & SPI_SR_FTLVL) != 0U) {}
+  while ((spi->SR & SPI_SR_BSY) != 0U) {}
+  // 2-lines: تفريغ الـ RX FIFO ومسح OVR كما يفعل HAL_SPI_Transmit في نهايته
+  while ((spi->SR & SPI_SR_FRLVL) != 0U) (void)*(__IO uint8_t *)&spi->DR;
+  __HAL_SPI_CLEAR_OVRFLAG(&hspi1);
+}
+static void TA_sendByte(uint8_t b){
+  TA_spiPump(&b, 1);
 }
+static uint8_t s_auto = 0;          // التحديث الذاتي (DMA + TIM14) فعّال
+static void TA_autoHold(void);
+static void TA_autoRelease(void);
+
 static void TA_cmd(uint8_t cmd){
+  TA_autoHold();
   TA_STB(0);
   TA_sendByte(cmd);
   TA_STB(1);
+  TA_autoRelease();
 }
-static void TA_writeSeq(uint8_t startAddr, const uint8_t *data, uint8_t len){
-  TA_cmd(0x40); // Data set: write, auto-increment
-  TA_STB(0);
+static TA_RAMFUNC void TA_writeSeq(uint8_t startAddr, const uint8_t *data, uint8_t len){
+  uint8_t c = 0x40;  // Data set: write, auto-increment
+  TA_STB(0); TA_spiPump(&c, 1); TA_STB(1);
+  if (len > 16) len = 16;
   uint8_t a = 0xC0 | (startAddr & 0x0F);
-  TA_sendByte(a);
-  for(uint8_t i=0;i<len && i<16;i++) TA_sendByte(data[i]);
+  TA_STB(0);
+  TA_spiPump(&a, 1);
+  TA_spiPump(data, len);
   TA_STB(1);
 }
 
 // ===== Font table (Common-Cathode; bit7 للـ dp خارجياً) =====
-static uint8_t font7seg[128];   // ASCII -> 7-seg pattern (bit7 for dp)
-static void font_init(void);
-
-static void font_init(void){
-  // digits '0'..'9' (حسب خريطتك CC)
-  font7seg['0'] = 0x3F; font7seg['1'] = 0x21; font7seg['2'] = 0x5D; font7seg['3'] = 0x75; font7seg['4'] = 0x63;
-  font7seg['5'] = 0x76; font7seg['6'] = 0x7E; font7seg['7'] = 0x25; font7seg['8'] = 0x7F; font7seg['9'] = 0x77;
-
-  // رموز شائعة
-  font7seg[' '] = 0x00; // فراغ
-  font7seg['-'] = 0x40; // شرطة (g فقط)
-  font7seg['_'] = 0x10; // underscore (d)
-
-  // حروف تقريبية (يمكن تعديلها بـ setGlyph)
-  font7seg['A'] = font7seg['a'] = 0x6F;
-  font7seg['b'] = 0x7A;
-  font7seg['C'] = 0x5A;
-  font7seg['c'] = 0x58;
-  font7seg['d'] = 0x79;
-  font7seg['E'] = 0x5E;
-  font7seg['F'] = 0x4E;
-  font7seg['G'] = 0x7A;
-  font7seg['H'] = 0x6C;
-  font7seg['I'] = 0x24;
-  font7seg['J'] = 0x31;
-  font7seg['K'] = 0x6C;
-  font7seg['L'] = 0x1A;
-  font7seg['M'] = 0x2D;
-  font7seg['N'] = 0x2C;
-  font7seg['n'] = 0x68;
-  font7seg['o'] = 0x78;
-  font7seg['P'] = 0x67;
-  font7seg['Q'] = 0x73;
-  font7seg['r'] = 0x48;
-  font7seg['S'] = 0x76;
-  font7seg['t'] = 0x5E & ~0x20;
-  font7seg['U'] = 0x3A;
-  font7seg['V'] = 0x3A;
-  font7seg['W'] = 0x3D;
-  font7seg['X'] = 0x6C;
-  font7seg['Y'] = 0x73;
-  font7seg['Z'] = 0x5B;
-}
+// يُولَّد وقت الترجمة من TA6932_WIRING (ta6932_font.h): لا font_init ولا إعادة ترتيب بتات
+#if TA6932_GLYPH_RAM
+static uint8_t font7seg[128] = TA6932_FONT_ASCII;        // .data: يُنسخ عند الإقلاع، setGlyph متاح
+#else
+static const uint8_t font7seg[128] = TA6932_FONT_ASCII;  // فلاش فقط (128 بايت RAM أقل)
+#endif
 
 // ===== Display control =====
 static uint8_t s_brightness = 7; // آخر مستوى سطوع
-static uint8_t g_buf[16];
+static uint8_t s_ctrl = 0xFF;    // آخر أمر تحكم أُرسل (0xFF = غير معروف → أرسل دائماً)
+// إطار الإرسال: s_frame[3] = 0xC0 (عنوان البداية) ثم الخانات الـ16 مباشرة بعده،
+// فيُرسل الـ DMA الحزمة كاملة (17 بايت) من مكان واحد. الخانات = الكلمات s_frameW[1..4].
+static uint32_t s_frameW[5];
+#define s_frame    ((uint8_t *)s_frameW)
+#define TA_FRAME   (s_frame + 3)
+#define TA_FRAME_LEN  17u
+#define TA_PHYS    (s_frame + 4)   // 16 خانة بترتيب الشبكات الفعلية
+#if defined(TA6932_DIGIT_MAP) || TA6932_USE_BLINK || TA6932_USE_LAYERS
+// البافر المنطقي منفصل؛ TA_flush يركّبه في الإطار (طبقات + وميض + خريطة الخانات)
+#define TA_COMPOSE 1
+static uint32_t s_base[4];
+#define TA_BASEW   s_base
+#else
+#define TA_COMPOSE 0
+#define TA_BASEW   (s_frameW + 1)
+#endif
+#define g_buf      ((uint8_t *)TA_BASEW)     // البايت n = خانة منطقية n (little-endian)
+
+// الإطار = (BASE | OVERLAY) & ~(HIDE | وميض)، كلمة كلمة
+#if TA6932_USE_LAYERS
+static uint32_t s_over[4];        // مؤشر/علامات dp فوق الأساس
+static uint32_t s_hide[4];        // قناع إطفاء (ANDN)
+#define TA__OVW(k)  (s_over[k])
+#define TA__HDW(k)  (s_hide[k])
+#else
+#define TA__OVW(k)  0u
+#define TA__HDW(k)  0u
+#endif
+#if TA6932_USE_BLINK
+static uint32_t s_blinkHide[4];   // المقاطع المطفأة في طور الوميض الحالي
+#define TA__BHW(k)  (s_blinkHide[k])
+#else
+#define TA__BHW(k)  0u
+#endif
+#define TA__WORD(k) ((TA_BASEW[k] | TA__OVW(k)) & ~(TA__HDW(k) | TA__BHW(k)))
+#define TA__BYTE(w, i)  ((uint8_t)((w) >> (8u * ((i) & 3u))))
+#define TA__COMPOSED(i)  TA__BYTE(TA__WORD((i) >> 2), (i))  // خانة منطقية واحدة كما ستُرسل
+
+#ifdef TA6932_DIGIT_MAP
+#define TA__SRC(i)  TA__BYTE(w[(i) >> 2], (i))
+#define TA__PERM(d, p0,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15) do {          \
+    d[p0]=TA__SRC(0);   d[p1]=TA__SRC(1);   d[p2]=TA__SRC(2);   d[p3]=TA__SRC(3);         \
+    d[p4]=TA__SRC(4);   d[p5]=TA__SRC(5);   d[p6]=TA__SRC(6);   d[p7]=TA__SRC(7);         \
+    d[p8]=TA__SRC(8);   d[p9]=TA__SRC(9);   d[p10]=TA__SRC(10); d[p11]=TA__SRC(11);       \
+    d[p12]=TA__SRC(12); d[p13]=TA__SRC(13); d[p14]=TA__SRC(14); d[p15]=TA__SRC(15); } while (0)
+#define TA__PERM_X(d, ...)     TA__PERM(d, __VA_ARGS__)
+#define TA__BIT16(p0,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15)                 \
+    ((1u<<(p0))|(1u<<(p1))|(1u<<(p2))|(1u<<(p3))|(1u<<(p4))|(1u<<(p5))|(1u<<(p6))|(1u<<(p7))| \
+     (1u<<(p8))|(1u<<(p9))|(1u<<(p10))|(1u<<(p11))|(1u<<(p12))|(1u<<(p13))|(1u<<(p14))|(1u<<(p15)))
+#define TA__BIT16_X(...)       TA__BIT16(__VA_ARGS__)
+_Static_assert(TA__BIT16_X(TA6932_DIGIT_MAP) == 0xFFFFu,
+               "TA6932_DIGIT_MAP: 16 distinct grids 0..15");
+static const uint8_t s_digitPhys[16] = { TA6932_DIGIT_MAP };   // للكتابة المفردة فقط (مسار بارد)
+
+// تركيب 4 كلمات ثم نسخ مفكوك بعناوين ثابتة وقت الترجمة
+static TA_INLINE void TA_flush(void){
+  const uint32_t w[4] = { TA__WORD(0), TA__WORD(1), TA__WORD(2), TA__WORD(3) };
+  TA__PERM_X(TA_PHYS, TA6932_DIGIT_MAP);
+}
+static TA_INLINE uint8_t TA_physAddr(uint8_t addr){ return s_digitPhys[addr & 0x0F]; }
+#else
+#if TA_COMPOSE
+// نفس الترتيب: 4 كلمات بدل 16 بايت
+static TA_INLINE void TA_flush(void){
+  uint32_t *d = s_frameW + 1;
+  d[0] = TA__WORD(0); d[1] = TA__WORD(1); d[2] = TA__WORD(2); d[3] = TA__WORD(3);
+}
+#else
+static TA_INLINE void TA_flush(void) {}
+#endif
+static TA_INLINE uint8_t TA_physAddr(uint8_t addr){ return addr & 0x0F; }
+#endif
+
+// يرسل أمر التحكم فقط إذا تغيّر عن آخر أمر (يتجنب تكرار 0x88|level)
+static void TA_ctrl(uint8_t cmd){
+  if (cmd == s_ctrl) return;
+  s_ctrl = cmd;
+  TA_cmd(cmd);
+}
 
 void TA6932_SetBrightness(uint8_t level){  // 0..7
   if(level > 7) level = 7;
   s_brightness = level;
-  TA_cmd(0x88 | (s_brightness & 0x07));  // Display ON + brightness
+  TA_ctrl(0x88 | (s_brightness & 0x07));  // Display ON + brightness
 }
 void TA6932_DisplayOn(void){
-  TA_cmd(0x88 | (s_brightness & 0x07));
+  TA_ctrl(0x88 | (s_brightness & 0x07));
 }
 void TA6932_DisplayOff(void){
-  TA_cmd(0x80); // OFF
+  TA_ctrl(0x80); // OFF
 }
 
 // ===== Buffer helpers =====
 void TA6932_putRaw(uint8_t addr, uint8_t v){ g_buf[addr & 0x0F] = v; }
 
-void TA6932_putDigit(uint8_t addr, int d, int dp){
+TA_RAMFUNC void TA6932_putDigit(uint8_t addr, int d, int dp){
   uint8_t v = 0x00;
   if (d >= 0 && d <= 9) v = font7seg['0' + d];
   if (dp) v |= 0x80;
-  TA6932_putRaw(addr, v);
+  g_buf[addr & 0x0F] = v;
 }
-void TA6932_putChar(uint8_t addr, char ch, int dp){
+TA_RAMFUNC void TA6932_putChar(uint8_t addr, char ch, int dp){
   uint8_t v = font7seg[(uint8_t)ch];
   if (v == 0x00 && ch != ' ') v = 0x00; // غير معرّف → فراغ
   if (dp) v |= 0x80;
-  TA6932_putRaw(addr, v);
+  g_buf[addr & 0x0F] = v;
 }
+#if TA6932_GLYPH_RAM
 void TA6932_setGlyph(uint8_t ch, uint8_t pattern){
-  font7seg[ch] = pattern & 0x7F; // bit7 للـ dp يُضاف خارجياً
+  font7seg[ch & 0x7F] = pattern & 0x7F; // bit7 للـ dp يُضاف خارجياً
 }
+#endif
 
-// تعبئة البافر كامل (بدون memcpy حسب تفضيلك)
+// تعبئة البافر كامل: memcpy إلى الكلمات الأربع (لا قراءة uint8_t[] عبر uint32_t* → strict aliasing)
+// GCC يحوّلها إلى 4 تحميلات كلمة إن كان المصدر محاذى، وإلا نسخ بايتات
 void TA6932_loadBuffer(const uint8_t *src){
-  for (int i=0;i<16;i++) g_buf[i] = src[i];
+  memcpy(TA_BASEW, src, 16);
 }
-void TA6932_loadBuffer16(uint8_t b0,uint8_t b1,uint8_t b2,uint8_t b3,
-                         uint8_t b4,uint8_t b5,uint8_t b6,uint8_t b7,
-                         uint8_t b8,uint8_t b9,uint8_t b10,uint8_t b11,
-                         uint8_t b12,uint8_t b13,uint8_t b14,uint8_t b15){
-  g_buf[0]=b0;  g_buf[1]=b1;  g_buf[2]=b2;  g_buf[3]=b3;
-  g_buf[4]=b4;  g_buf[5]=b5;  g_buf[6]=b6;  g_buf[7]=b7;
-  g_buf[8]=b8;  g_buf[9]=b9;  g_buf[10]=b10; g_buf[11]=b11;
-  g_buf[12]=b12; g_buf[13]=b13; g_buf[14]=b14; g_buf[15]=b15;
+// 4 وسائط في r0..r3: لا شيء على المكدس (بديل loadBuffer16 ذات الـ 16 وسيطاً)
+void TA6932_loadWords(uint32_t w0, uint32_t w1, uint32_t w2, uint32_t w3){
+  uint32_t *d = TA_BASEW;
+  d[0] = w0; d[1] = w1; d[2] = w2; d[3] = w3;
+}
+
+// ===== Layers: عمليات كلمة 32-بت على 4 كلمات =====
+// خانات (bit n = خانة n) → قناع بايتات لكلمة واحدة (4 خانات)
+static const uint32_t s_nibMask[16] = {
+  0x00000000u, 0x000000FFu, 0x0000FF00u, 0x0000FFFFu,
+  0x00FF0000u, 0x00FF00FFu, 0x00FFFF00u, 0x00FFFFFFu,
+  0xFF000000u, 0xFF0000FFu, 0xFF00FF00u, 0xFF00FFFFu,
+  0xFFFF0000u, 0xFFFF00FFu, 0xFFFFFF00u, 0xFFFFFFFFu,
+};
+#define TA__REP(segs)       ((uint32_t)(segs) * 0x01010101u)
+#define TA__DMASK(d, k)     (s_nibMask[((d) >> (4u * (k))) & 0x0Fu])
+
+uint32_t *TA6932_LayerWords(TA6932_Layer layer){
+  switch (layer){
+  case TA6932_LAYER_BASE:    return TA_BASEW;
+#if TA6932_USE_LAYERS
+  case TA6932_LAYER_OVERLAY: return s_over;
+  case TA6932_LAYER_HIDE:    return s_hide;
+#endif
+  default:                   return NULL;
+  }
+}
+void TA6932_LayerOr(TA6932_Layer layer, uint16_t digits, uint8_t segs){
+  uint32_t *p = TA6932_LayerWords(layer), r = TA__REP(segs);
+  if (!p) return;
+  p[0] |= TA__DMASK(digits, 0) & r; p[1] |= TA__DMASK(digits, 1) & r;
+  p[2] |= TA__DMASK(digits, 2) & r; p[3] |= TA__DMASK(digits, 3) & r;
+}
+void TA6932_LayerAndn(TA6932_Layer layer, uint16_t digits, uint8_t segs){
+  uint32_t *p = TA6932_LayerWords(layer), r = TA__REP(segs);
+  if (!p) return;
+  p[0] &= ~(TA__DMASK(digits, 0) & r); p[1] &= ~(TA__DMASK(digits, 1) & r);
+  p[2] &= ~(TA__DMASK(digits, 2) & r); p[3] &= ~(TA__DMASK(digits, 3) & r);
+}
+void TA6932_LayerXor(TA6932_Layer layer, uint16_t digits, uint8_t segs){
+  uint32_t *p = TA6932_LayerWords(layer), r = TA__REP(segs);
+  if (!p) return;
+  p[0] ^= TA__DMASK(digits, 0) & r; p[1] ^= TA__DMASK(digits, 1) & r;
+  p[2] ^= TA__DMASK(digits, 2) & r; p[3] ^= TA__DMASK(digits, 3) & r;
+}
+void TA6932_LayerFill(TA6932_Layer layer, uint8_t segs){
+  uint32_t *p = TA6932_LayerWords(layer), r = TA__REP(segs);
+  if (!p) return;
+  p[0] = r; p[1] = r; p[2] = r; p[3] = r;
 }
 
 // ===== Public API =====
+#if TA6932_HW_STB
+// PA4 → SPI1_NSS، والـ SPI يقود NSS بنفسه (SSM=0, SSOE=1, NSSP=0)
+static void TA_hwStbInit(void){
+  GPIO_InitTypeDef g = {0};
+  SPI_TypeDef *spi = hspi1.Instance;
+
+  CLEAR_BIT(spi->CR1, SPI_CR1_SPE);
+  CLEAR_BIT(spi->CR1, SPI_CR1_SSM | SPI_CR1_SSI);
+  CLEAR_BIT(spi->CR2, SPI_CR2_NSSP);
+  SET_BIT(spi->CR2, SPI_CR2_SSOE);
+  hspi1.Init.NSS      = SPI_NSS_HARD_OUTPUT;
+  hspi1.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+
+  g.Pin       = TA_STB_PIN;
+  g.Mode      = GPIO_MODE_AF_PP;
+  g.Pull      = GPIO_PULLUP;                 // STB يبقى HIGH إن تُرك الطرف عائماً
+  g.Speed     = GPIO_SPEED_FREQ_HIGH;
+  g.Alternate = GPIO_AF0_SPI1;
+  HAL_GPIO_Init(TA_STB_PORT, &g);
+}
+#endif
+
 void TA6932_Init(void){
+#if TA6932_HW_STB
+  TA_hwStbInit();
+#endif
   TA_STB(1);                 // STB idle HIGH
-  font_init();               // تهيئة الفونت
+  s_frame[3] = 0xC0;         // عنوان البداية أمام g_buf
   s_brightness = 7;
+  s_ctrl = 0xFF;             // حالة الشاشة غير معروفة بعد الإقلاع
   TA6932_DisplayOn();        // تشغيل على سطوع 7
 }
-void TA6932_WriteAll(void){
-  TA_writeSeq(0x00, g_buf, 16);
+TA_RAMFUNC void TA6932_WriteAll(void){
+  TA_flush();                  // منطقي → فعلي (لا شيء بدون خريطة/وميض)
+  if (s_auto) return;          // الـ DMA يرسل الإطار في الدورة التالية
+  TA_writeSeq(0x00, TA_PHYS, 16);
+}
+// يرسل الخانات المنطقية المذكورة في mask فقط: أقصر مدى متصل من الشبكات يغطيها (أمر واحد)
+TA_RAMFUNC void TA6932_WriteDirty(uint16_t mask){
+  uint16_t p = 0;
+  if (!mask) return;
+  TA_flush();
+#ifdef TA6932_DIGIT_MAP
+  for (uint8_t i = 0; i < 16; i++)
+    if (mask & (1u << i)) p |= (uint16_t)(1u << s_digitPhys[i]);
+#else
+  p = mask;
+#endif
+  if (s_auto) return;          // الـ DMA يرسل الإطار كاملاً على أي حال
+  uint8_t lo = 0, hi = 15;
+  while (!(p & (1u << lo))) lo++;
+  while (!(p & (1u << hi))) hi--;
+  TA_writeSeq(lo, TA_PHYS + lo, (uint8_t)(hi - lo + 1));
 }
 void TA6932_Clear(void){
-  for (int i=0;i<16;i++) g_buf[i] = 0x00;
+  TA6932_loadWords(0, 0, 0, 0);
   TA6932_WriteAll();
 }
 
+// ===== Blink attribute plane =====
+#if TA6932_USE_BLINK
+static uint16_t s_blinkOn    = 0;     // خانات لها وميض
+static uint16_t s_blinkOff   = 0;     // خانات في طور الإطفاء الآن
+static uint16_t s_blinkDirty = 0;     // تغيّر الإعداد: أرسلها في الـ tick القادم
+static uint8_t  s_blinkSegs[16];      // المقاطع التي تُطفأ (0x80 = dp فقط)
+static uint16_t s_blinkHalf[16];      // نصف الدورة بالميلي ثانية
+static uint32_t s_blinkNext[16];      // HAL tick للتبديل القادم
+
+void TA6932_SetBlink(uint8_t addr, uint8_t segs, uint16_t period_ms, uint16_t phase_ms){
+  uint8_t  i = addr & 0x0F;
+  uint16_t bit = (uint16_t)(1u << i);
+  uint8_t  off = 0;
+  if (!segs || period_ms < 2){
+    s_blinkOn &= (uint16_t)~bit;
+  } else {
+    uint16_t half = period_ms >> 1;
+    uint16_t p = phase_ms % period_ms;  // مسار بارد: القسمة مقبولة هنا
+    off = (p >= half);
+    s_blinkSegs[i] = segs;
+    s_blinkHalf[i] = half;
+    s_blinkNext[i] = HAL_GetTick() + (off ? (uint16_t)(period_ms - p) : (uint16_t)(half - p));
+    s_blinkOn |= bit;
+  }
+  if (off) s_blinkOff |= bit; else s_blinkOff &= (uint16_t)~bit;
+  ((uint8_t *)s_blinkHide)[i] = off ? segs : 0x00;
+  s_blinkDirty |= bit;
+}
+
+uint8_t TA6932_BlinkActive(void){ return (uint8_t)(s_blinkOn != 0); }
+
+uint16_t TA6932_BlinkTask(void){
+  uint16_t dirty = s_blinkDirty;
+  if (!s_blinkOn && !dirty) return 0;
+  uint32_t now = HAL_GetTick();
+  for (uint8_t i = 0; i < 16; i++){
+    uint16_t bit = (uint16_t)(1u << i);
+    if (!(s_blinkOn & bit) || (int32_t)(now - s_blinkNext[i]) < 0) continue;
+    s_blinkNext[i] += s_blinkHalf[i];  // خانات بنفس الدورة تبقى متزامنة
+    if ((int32_t)(now - s_blinkNext[i]) >= 0) s_blinkNext[i] = now + s_blinkHalf[i];  // بعد نوم طويل
+    s_blinkOff ^= bit;
+    ((uint8_t *)s_blinkHide)[i] = (s_blinkOff & bit) ? s_blinkSegs[i] : 0x00;
+    uint32_t k = i >> 2;
+    if (TA__BYTE((TA_BASEW[k] | TA__OVW(k)) & ~TA__HDW(k), i) & s_blinkSegs[i])
+      dirty |= bit;                    // يتغير الظاهر فعلاً فقط
+  }
+  s_blinkDirty = 0;
+  TA6932_WriteDirty(dirty);
+  return dirty;
+}
+#endif
+
 // ===== Fixed-address single write (واجهات قديمة) =====
 void TA6932_WriteOneRaw(uint8_t addr, uint8_t value){
-  // 0x44: fixed-address write. ثم [0xC0|addr] + [data].
-  TA_STB(0); uint8_t cmd = 0x44; HAL_SPI_Transmit(&hspi1, &cmd, 1, 10); TA_STB(1);
+  TA6932_putRaw(addr, value); // مزامنة البافر
+  uint8_t grid = TA_physAddr(addr);
+  value = TA__COMPOSED(addr & 0x0Fu);  // طبقات + طور الوميض الحالي
+  TA_PHYS[grid] = value;
+  if (s_auto) return;         // يظهر مع الإطار التالي
+  // 0x44: fixed-address write. ثم [0xC0|grid] + [data].
+  TA_cmd(0x44);
+  uint8_t f[2] = { (uint8_t)(0xC0 | grid), value };
   TA_STB(0);
-  uint8_t a = 0xC0 | (addr & 0x0F);
-  HAL_SPI_Transmit(&hspi1, &a, 1, 10);
-  HAL_SPI_Transmit(&hspi1, &value, 1, 10);
+  TA_spiPump(f, 2);
   TA_STB(1);
-  TA6932_putRaw(addr, value); // مزامنة البافر
 }
 void TA6932_putDigitOne(uint8_t addr, int d, int dp){
   uint8_t v = 0x00;
@@ -165,7 +400,7 @@ void TA6932_putCharOne(uint8_t addr, char ch, int dp){
 }
 
 // ===== Unified One-API (الجديدة) =====
-static uint8_t TA_resolveValue(int value, int dp){
+static TA_RAMFUNC uint8_t TA_resolveValue(int value, int dp){
   uint8_t v = 0x00;
   if (value & 0x100){                // RAW via TA_RAW()
     v = (uint8_t)(value & 0xFF);
@@ -183,29 +418,101 @@ void TA6932_putOne(uint8_t addr, int value, int dp){
   uint8_t v = TA_resolveValue(value, dp);
   TA6932_WriteOneRaw(addr, v);
 }
-void TA6932_putOneBuf(uint8_t addr, int value, int dp){
-  uint8_t v = TA_resolveValue(value, dp);
-  TA6932_putRaw(addr, v);
+TA_RAMFUNC void TA6932_putOneBuf(uint8_t addr, int value, int dp){
+  g_buf[addr & 0x0F] = TA_resolveValue(value, dp);
+}
+
+// ===== Temperature formatter (integer only) =====
+// v/10 بدون قسمة (M0+ لا يملك UDIV): صحيح تماماً لكل v < 16389
+static inline uint16_t TA_div10(uint16_t v){
+  return (uint16_t)(((uint32_t)v * 6554u) >> 16);
+}
+// مدى العرض: "-99C" .. "163C" (كما في ta6932.h)؛ الحد الأعلى من دقة TA_div10: |centi| + 5 ≤ 16383
+#define TA_TEMP_MIN  (-9949)
+#define TA_TEMP_MAX  16378
+void TA6932_putTemperature(uint8_t addr, int16_t centi){
+  if (centi < TA_TEMP_MIN) centi = TA_TEMP_MIN;
+  if (centi > TA_TEMP_MAX) centi = TA_TEMP_MAX;
+  uint8_t  neg = (centi < 0);
+  uint16_t t   = TA_div10((uint16_t)((neg ? -centi : centi) + 5)); // أعشار الدرجة مع التقريب
+  uint16_t ip  = TA_div10(t);                                      // الجزء الصحيح
+  uint8_t  fr  = (uint8_t)(t - ip * 10u);                          // العُشر
+  uint8_t  c[3];
+  uint8_t  dp  = 1;                                                // dp بعد خانة الآحاد
+
+  if (ip >= 100 || (neg && ip >= 10)){       // لا مكان للعُشر
+    uint16_t h = TA_div10(ip);
+    c[2] = (uint8_t)(ip - h * 10u);
+    c[1] = (uint8_t)(h - TA_div10(h) * 10u);
+    c[0] = neg ? '-' : (uint8_t)TA_div10(h);
+    dp = 0;
+  } else {
+    uint16_t tens = TA_div10(ip);
+    c[0] = neg ? '-' : (tens ? (uint8_t)tens : ' ');
+    c[1] = (uint8_t)(ip - tens * 10u);
+    c[2] = fr;
+  }
+  TA6932_putOneBuf(addr,     c[0], 0);
+  TA6932_putOneBuf(addr + 1, c[1], dp);
+  TA6932_putOneBuf(addr + 2, c[2], 0);
+  TA6932_putOneBuf(addr + 3, 'C', 0);
+}
+
+// ===== Raw DS3231 BCD → segments =====
+// نصف بايت > 9 (سجل تالف) → خانة فارغة
+static TA_INLINE uint8_t TA_nibble(uint8_t n){
+  return (n <= 9) ? font7seg['0' + n] : 0x00;
+}
+TA_RAMFUNC void TA6932_putBCD(uint8_t addr, uint8_t bcd, int dp){
+  g_buf[addr & 0x0F]       = TA_nibble(bcd >> 4);
+  g_buf[(addr + 1) & 0x0F] = (uint8_t)(TA_nibble(bcd & 0x0F) | (dp ? 0x80 : 0x00));
+}
+
+// أقنعة البتات غير الزمنية (CH/12-24h/century) وعنوان كل حقل؛ اليوم (0x03) لا يُرسم
+static const uint8_t s_bcdMask[7] = { 0x7F, 0x7F, 0x3F, 0x07, 0x3F, 0x1F, 0xFF };
+static const uint8_t s_bcdAddr[7] = {
+  TA6932_CLK_ADDR_SS, TA6932_CLK_ADDR_MM, TA6932_CLK_ADDR_HH, 0xFF,
+  TA6932_CLK_ADDR_DATE, TA6932_CLK_ADDR_MON, TA6932_CLK_ADDR_YYYY + 2
+};
+static uint8_t s_bcdLast[7];
+static uint8_t s_bcdValid = 0;
+
+TA_RAMFUNC uint8_t TA6932_RenderClockBCD(const uint8_t *raw){
+  uint8_t changed = 0;
+  for (uint8_t i = 0; i < 7; i++){
+    uint8_t b = raw[i] & s_bcdMask[i];
+    if (b != s_bcdLast[i] || !s_bcdValid){ s_bcdLast[i] = b; changed |= (uint8_t)(1u << i); }
+  }
+  if (!changed) return 0;            // الحالة المعتادة بين ثانيتين: 7 مقارنات فقط
+  for (uint8_t i = 0; i < 7; i++){
+    uint8_t a = s_bcdAddr[i];
+    if (!(changed & (1u << i)) || a == 0xFF) continue;
+    uint8_t d0 = g_buf[a & 0x0F] & 0x80, d1 = g_buf[(a + 1) & 0x0F] & 0x80;
+    TA6932_putBCD(a, s_bcdLast[i], 0);
+    g_buf[a & 0x0F] |= d0;
+    g_buf[(a + 1) & 0x0F] |= d1;
+  }
+  if (!s_bcdValid){                  // القرن ثابت: "20"
+    g_buf[TA6932_CLK_ADDR_YYYY]     = (uint8_t)(TA_nibble(2) | (g_buf[TA6932_CLK_ADDR_YYYY] & 0x80));
+    g_buf[TA6932_CLK_ADDR_YYYY + 1] = (uint8_t)(TA_nibble(0) | (g_buf[TA6932_CLK_ADDR_YYYY + 1] & 0x80));
+    s_bcdValid = 1;
+  }
+  return changed;
 }
+void TA6932_RenderClockReset(void){ s_bcdValid = 0; }
 
 // ===== Demos =====
 void TA6932_TestPattern(void){
-  // HH:MM = 12:34
-  TA6932_putDigit(0x00,1,0); TA6932_putDigit(0x01,2,0);
-  TA6932_putDigit(0x02,3,0); TA6932_putDigit(0x03,4,0);
-  // SS = 56
-  TA6932_putDigit(0x04,5,0); TA6932_putDigit(0x05,6,0);
-  // YYYY = 2025
-  TA6932_putDigit(0x06,2,0); TA6932_putDigit(0x07,0,0);
-  TA6932_putDigit(0x08,2,0); TA6932_putDigit(0x09,5,0);
-  // MM = 09
-  TA6932_putDigit(0x0A,0,0); TA6932_putDigit(0x0B,9,0);
-  // DD = 22
-  TA6932_putDigit(0x0C,2,0); TA6932_putDigit(0x0D,2,0);
-  // D15 colon (dp)
-  TA6932_putRaw(0x0E,0x80);
-  // D16 weekday off
-  TA6932_putRaw(0x0F,0x00);
+  // خانات منطقية (TA6932_CLK_ADDR_*)؛ الخريطة تضعها على الشبكات عند الإرسال
+  TA6932_putBCD(TA6932_CLK_ADDR_HH,       0x12, 0);  // HH:MM = 12:34
+  TA6932_putBCD(TA6932_CLK_ADDR_MM,       0x34, 0);
+  TA6932_putBCD(TA6932_CLK_ADDR_SS,       0x56, 0);  // SS = 56
+  TA6932_putBCD(TA6932_CLK_ADDR_YYYY,     0x20, 0);  // YYYY = 2025
+  TA6932_putBCD(TA6932_CLK_ADDR_YYYY + 2, 0x25, 0);
+  TA6932_putBCD(TA6932_CLK_ADDR_MON,      0x09, 0);  // MM = 09
+  TA6932_putBCD(TA6932_CLK_ADDR_DATE,     0x22, 0);  // DD = 22
+  TA6932_putRaw(TA6932_CLK_ADDR_COLON, 0x80);        // colon (dp)
+  TA6932_putRaw(TA6932_CLK_ADDR_WDAY,  0x00);        // weekday off
   TA6932_WriteAll();
 }
 void TA6932_CounterDemo(void){
@@ -219,3 +526,184 @@ void TA6932_CounterDemo(void){
     HAL_Delay(1000);
   }
 }
+
+// ===== Autonomous refresh (TIM14 → STB, DMAMUX sync → DMA → SPI1) =====
+// TIM14_CH1 على PA4 (AF4) هو STB نفسه: PWM معكوس، منخفض من بداية الدورة حتى CCR1.
+// صعود OC1REF عند بداية الدورة يفتح مزامنة DMAMUX لـ 17 طلب SPI1_TX فقط،
+// فتخرج الحزمة [0xC0][g_buf] كاملة داخل نافذة STB المنخفض. لا تدخّل من المعالج.
+// أوامر التحكم (سطوع/تشغيل) تُرسل بين إطارين: يتوقف المؤقت ويعود PA4 إلى GPIO مؤقتاً.
+#if TA6932_HW_STB
+// STB على SPI1_NSS: التحديث الذاتي غير متاح (يحتاج PA4 كـ TIM14_CH1)
+static void TA_autoHold(void){}
+static void TA_autoRelease(void){}
+HAL_StatusTypeDef TA6932_AutoStart(uint16_t period_us){ (void)period_us; return HAL_ERROR; }
+void TA6932_AutoStop(void){}
+#else
+static DMA_HandleTypeDef s_hdma;
+
+static inline void TA_stbPinMode(uint32_t mode){   // 1 = GPIO output, 2 = AF
+  uint32_t pos = 0;
+  while (((TA_STB_PIN >> pos) & 1u) == 0u) pos++;
+  MODIFY_REG(TA_STB_PORT->MODER, 3u << (2u * pos), mode << (2u * pos));
+}
+
+static uint32_t s_autoCnt;          // CNT عند الإيقاف المؤقت: يُستأنف منه فلا يتأخر الإطار التالي
+
+// يوقف بعد اكتمال الإطار الجاري (CNT بين CCR1 ونهاية الدورة) ويعيد STB إلى GPIO
+// الانتظار ≤ زمن إطار واحد + TA6932_AUTO_GUARD_US (لا دورة تحديث كاملة)
+static void TA_autoHold(void){
+  uint32_t cnt;
+  if (!s_auto || !READ_BIT(TIM14->CR1, TIM_CR1_CEN)) return;   // متوقف مسبقاً (داخل hook الساعة)
+  do {
+    cnt = TIM14->CNT;
+  } while (cnt < TIM14->CCR1 || cnt + TA6932_AUTO_GUARD_US > TIM14->ARR);
+  CLEAR_BIT(TIM14->CR1, TIM_CR1_CEN);
+  s_autoCnt = TIM14->CNT;
+  CLEAR_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN);
+  TA_STB_PORT->BSRR = TA_STB_PIN;
+  TA_stbPinMode(1u);
+}
+static void TA_autoRelease(void){
+  if (!s_auto) return;
+  TIM14->CNT = s_autoCnt;     // STB مرتفع؛ الإطار التالي في موعده عند نهاية الدورة
+  TA_stbPinMode(2u);
+  SET_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN);
+  SET_BIT(TIM14->CR1, TIM_CR1_CEN);
+}
+
+// زمن الحزمة + t_CLK_STB + هامش لزمن استجابة الـ DMA، على SCK الحالي
+static uint32_t TA_autoFrameUs(void){
+  uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+  uint32_t sck  = pclk >> (((hspi1.Instance->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos) + 1u);
+  return (TA_FRAME_LEN * 8u * 1000000u) / sck + TA6932_T_CLK_STB_NS / 1000u + 3u;
+}
+
+// clk_gov: قبل تغيير الساعة يتوقف بين إطارين (لا BR/SPE وسط إطار)، وبعده يعيد ضبط
+// TIM14 على الساعة الجديدة فوراً. PSC وCCR1 مُحمَّلان مسبقاً → UG، مع OC1 مُجبَر على
+// الخمول أثناءه كي لا يولّد تصفير العدّاد صعود OC1REF (= مزامنة DMAMUX وإطار زائد).
+static void TA_autoClkHook(uint8_t before){
+  uint32_t frame_us, ccmr;
+  if (!s_auto) return;
+  if (before){ TA_autoHold(); return; }
+
+  frame_us = TA_autoFrameUs();
+  if (frame_us + TA6932_PW_STB_NS / 1000u + TA6932_AUTO_GUARD_US >= TIM14->ARR + 1u){
+    TA6932_AutoStop();                             // الإطار لم يعد يتسع في الدورة
+    return;
+  }
+  TIM14->PSC   = HAL_RCC_GetPCLK1Freq() / 1000000u - 1u;
+  TIM14->CCR1  = frame_us;
+  ccmr         = TIM14->CCMR1;
+  TIM14->CCMR1 = (ccmr & ~TIM_CCMR1_OC1M) | TIM_CCMR1_OC1M_2;   // Force inactive
+  TIM14->EGR   = TIM_EGR_UG;
+  if (s_autoCnt < frame_us) s_autoCnt = frame_us;
+  TIM14->CNT   = s_autoCnt;
+  TIM14->CCMR1 = ccmr;                             // PWM1 من جديد، CNT ≥ CCR1: STB مرتفع
+  TA_autoRelease();
+}
+
+HAL_StatusTypeDef TA6932_AutoStart(uint16_t period_us){
+  HAL_DMA_MuxSyncConfigTypeDef sync = {0};
+  GPIO_InitTypeDef g = {0};
+  uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+  uint32_t frame_us = TA_autoFrameUs();
+
+  if (s_auto) return HAL_OK;
+  if (period_us <= frame_us + TA6932_PW_STB_NS / 1000u + TA6932_AUTO_GUARD_US) return HAL_ERROR;
+
+  TA_cmd(0x40);                                    // Data set: auto-increment (يبقى فعّالاً)
+
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  s_hdma.Instance                 = TA6932_AUTO_DMA_CH;
+  s_hdma.Init.Request             = DMA_REQUEST_SPI1_TX;
+  s_hdma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+  s_hdma.Init.PeriphInc           = DMA_PINC_DISABLE;
+  s_hdma.Init.MemInc              = DMA_MINC_ENABLE;
+  s_hdma.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;   // كتابة 8-بت إلى DR
+  s_hdma.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+  s_hdma.Init.Mode                = DMA_CIRCULAR;
+  s_hdma.Init.Priority            = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(&s_hdma) != HAL_OK) return HAL_ERROR;
+
+  sync.SyncSignalID  = HAL_DMAMUX1_SYNC_TIM14_OC;
+  sync.SyncPolarity  = HAL_DMAMUX_SYNC_RISING;     // صعود OC1REF = بداية الدورة
+  sync.SyncEnable    = ENABLE;
+  sync.EventEnable   = DISABLE;
+  sync.RequestNumber = TA_FRAME_LEN;
+  if (HAL_DMAEx_ConfigMuxSync(&s_hdma, &sync) != HAL_OK) return HAL_ERROR;
+  if (HAL_DMA_Start(&s_hdma, (uint32_t)TA_FRAME, (uint32_t)&hspi1.Instance->DR, TA_FRAME_LEN) != HAL_OK)
+    return HAL_ERROR;
+
+  SET_BIT(hspi1.Instance->CR1, SPI_CR1_SPE);
+  SET_BIT(hspi1.Instance->CR2, SPI_CR2_TXDMAEN);
+
+  // TIM14: نبضة 1us، PWM1 على CH1 بقطبية معكوسة (STB منخفض بينما CNT < CCR1)
+  __HAL_RCC_TIM14_CLK_ENABLE();
+  TIM14->CR1   = TIM_CR1_ARPE;
+  TIM14->PSC   = pclk / 1000000u - 1u;
+  TIM14->ARR   = period_us - 1u;
+  TIM14->CCR1  = frame_us;
+  TIM14->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE;
+  TIM14->CCER  = TIM_CCER_CC1E | TIM_CCER_CC1P;
+  TIM14->EGR   = TIM_EGR_UG;
+  TIM14->CNT   = frame_us;                           // ابدأ في الجزء المرتفع من STB
+
+  TA_STB_PORT->BSRR = TA_STB_PIN;
+  g.Pin       = TA_STB_PIN;
+  g.Mode      = GPIO_MODE_AF_PP;
+  g.Pull      = GPIO_NOPULL;
+  g.Speed     = GPIO_SPEED_FREQ_HIGH;
+  g.Alternate = GPIO_AF4_TIM14;
+  HAL_GPIO_Init(TA_STB_PORT, &g);
+
+  s_auto = 1;
+  ClkGov_SetSwitchHook(TA_autoClkHook);            // تغيير الساعة بين إطارين فقط
+  SET_BIT(TIM14->CR1, TIM_CR1_CEN);
+  return HAL_OK;
+}
+
+void TA6932_AutoStop(void){
+  if (!s_auto) return;
+  TA_autoHold();                 // حدود إطار، STB على GPIO مرتفع
+  (void)HAL_DMA_Abort(&s_hdma);
+  (void)HAL_DMA_DeInit(&s_hdma);
+  TIM14->CCER = 0;
+  __HAL_RCC_TIM14_CLK_DISABLE();
+  ClkGov_SetSwitchHook(NULL);
+  s_auto = 0;
+}
+#endif // TA6932_HW_STB
+
+uint8_t TA6932_AutoActive(void){
+  return s_auto;
+}
+
+// ===== STB timing check (host model) =====
+// SPI Mode 0: BSY ينتهي بعد نصف دورة SCK من آخر حافة صاعدة، تليه حلقة t_CLK_STB.
+// STB مرتفع = حلقة PW_STB وحدها (لا انتظار قبل النزول).
+uint8_t TA6932_CheckStbTiming(uint32_t sck_hz, uint32_t cpu_hz, TA6932_StbTiming *t){
+  TA6932_StbTiming r;
+  uint32_t mhz = cpu_hz / 1000000u, loopNs;
+  if (sck_hz == 0 || mhz == 0) return 0;
+  loopNs      = (TA_STB_GAP_LOOPS * TA_STB_LOOP_CYCLES * 1000u) / mhz;
+  r.clkStbNs  = 500000000UL / sck_hz + loopNs;
+  r.stbHighNs = loopNs;
+  if (t) *t = r;
+  return (r.clkStbNs >= TA6932_T_CLK_STB_NS) && (r.stbHighNs >= TA6932_PW_STB_NS);
+}
+
+// ===== Benchmark: زمن التحديث الكامل وكلفة الـ RAM =====
+// يقارن بناءين (TA6932_USE_RAMFUNC=1 مقابل 0) على نفس اللوحة
+uint32_t TA6932_BenchRefresh(uint16_t n){
+  if (n == 0) return 0;
+  uint32_t t0 = PROF_Stamp();
+  for (uint16_t i = 0; i < n; i++){
+    TA6932_putDigit(i & 0x0F, i & 7, 0);   // مسار الرسم
+    TA6932_WriteAll();                     // مسار الإرسال
+  }
+  return PROF_Cycles(t0) / n;
+}
+uint16_t TA6932_RamFuncBytes(void){
+  extern uint8_t _sramfunc[], _eramfunc[];  // من سكربت الربط
+  return (uint16_t)(_eramfunc - _sramfunc);
+}
@@ -0,0 +1,129 @@
+// TA6932 fade engine
+// Version: 1.0
+//Date:19/10/2026
+// - يحوّل مستوى إدراكي 0..255 (gamma 2.2) إلى درجات السطوع الثمانية للـ TA6932
+// - dithering على مستوى الإطار بين الدرجتين المحيطتين (sigma-delta من الدرجة الأولى) أثناء الـ fade فقط؛
+//   في السكون الدرجة الأقرب (لا أوامر SPI)، إلا مع TA6932_FADE_DITHER_STEADY=1.
+//   يُعطَّل أثناء التحديث الذاتي (كل أمر فيه ينتظر نافذة بين إطارين) → الدرجة الأقرب
+// - أي مستوى غير صفري لا ينزل تحت الدرجة 1 (لا dithering بين OFF و1/16 = وميض مرئي)
+// - fade غير حاجب مع callback عند الانتهاء
+// - لا يرسل 0x88|level إلا إذا تغيّرت الدرجة الفعلية (انظر TA_ctrl في ta6932.c)
+
+#include "ta6932_fade.h"
+
+// level (0..255) -> duty بوحدات 1/256 (gamma 2.2، أقصى قيمة 14/16 = 224)
+static const uint8_t s_gamma[256] = {
+    0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+    1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,
+    2,   2,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   5,   5,   5,   5,
+    6,   6,   6,   6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  10,
+   11,  11,  11,  12,  12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,
+   17,  18,  18,  19,  19,  20,  21,  21,  22,  22,  23,  23,  24,  24,  25,  26,
+   26,  27,  27,  28,  29,  29,  30,  30,  31,  32,  32,  33,  34,  35,  35,  36,
+   37,  37,  38,  39,  40,  40,  41,  42,  43,  43,  44,  45,  46,  47,  47,  48,
+   49,  50,  51,  52,  53,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+   64,  65,  66,  67,  68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,
+   80,  81,  83,  84,  85,  86,  87,  88,  89,  91,  92,  93,  94,  95,  97,  98,
+   99, 100, 102, 103, 104, 105, 107, 108, 109, 111, 112, 113, 115, 116, 117, 119,
+  120, 121, 123, 124, 126, 127, 128, 130, 131, 133, 134, 136, 137, 139, 140, 142,
+  143, 145, 146, 148, 149, 151, 152, 154, 155, 157, 159, 160, 162, 164, 165, 167,
+  168, 170, 172, 173, 175, 177, 179, 180, 182, 184, 185, 187, 189, 191, 192, 194,
+  196, 198, 200, 201, 203, 205, 207, 209, 211, 213, 214, 216, 218, 220, 222, 224,
+};
+
+// duty الفعلي لكل درجة عتاد بوحدات 1/256: [0]=OFF، [k]=سطوع k-1 (1/16..14/16)
+static const uint8_t s_hwDuty[9] = { 0, 16, 32, 64, 160, 176, 192, 208, 224 };
+
+static uint8_t  s_level   = 255;  // المستوى الإدراكي الحالي
+static uint8_t  s_lo      = 8;    // الدرجة السفلى (فهرس في s_hwDuty)
+static uint8_t  s_frac    = 0;    // نسبة الدرجة العليا 0..255
+static uint8_t  s_acc     = 0;    // مُراكِم الـ dithering
+
+static uint8_t  s_active  = 0;
+static uint8_t  s_from, s_to;
+static uint16_t s_dur;
+static uint32_t s_t0;
+static uint32_t s_lastFrame;
+static TA6932_FadeCallback s_cb = 0;
+
+static void fade_applyStep(uint8_t step){
+  if (step == 0) TA6932_DisplayOff();
+  else           TA6932_SetBrightness((uint8_t)(step - 1));
+}
+
+// يحسب الدرجتين والكسر مرة واحدة لكل تغيّر مستوى (لا قسمة داخل الإطار)
+static void fade_setLevel(uint8_t level){
+  uint8_t d = s_gamma[level];
+  uint8_t k = 0;
+  s_level = level;
+  if (level && d < s_hwDuty[1]) d = s_hwDuty[1];     // أخفت من 1/16 → الدرجة 1 نفسها
+  while (k < 8 && d >= s_hwDuty[k + 1]) k++;
+  s_lo = k;
+  if (k == 8) { s_frac = 0; return; }
+  s_frac = (uint8_t)(((uint16_t)(d - s_hwDuty[k]) << 8) / (s_hwDuty[k + 1] - s_hwDuty[k]));
+}
+
+// 1 → الكسر يُقرَّب بالـ dithering، وإلا بالدرجة الأقرب
+static uint8_t fade_dithering(void){
+  if (!s_frac || TA6932_AutoActive()) return 0;
+  return (uint8_t)(s_active || TA6932_FADE_DITHER_STEADY);
+}
+
+static void fade_frame(void){
+  uint8_t step = s_lo;
+  if (fade_dithering()){
+    uint16_t a = (uint16_t)s_acc + s_frac;
+    s_acc = (uint8_t)a;
+    if (a > 0xFF) step++;
+  } else if (s_frac >= 128){
+    step++;
+  }
+  fade_applyStep(step);
+}
+
+void TA6932_SetLevel(uint8_t level){
+  s_active = 0;
+  s_cb = 0;
+  fade_setLevel(level);
+  fade_frame();
+}
+
+uint8_t TA6932_GetLevel(void){ return s_level; }
+
+void TA6932_FadeTo(uint8_t level, uint16_t duration_ms, TA6932_FadeCallback cb){
+  s_from = s_level;
+  s_to = level;
+  s_dur = duration_ms;       // 0 => يُطبَّق في أول FadeTask ثم يُستدعى cb
+  s_t0 = HAL_GetTick();
+  s_lastFrame = s_t0;
+  s_cb = cb;
+  s_active = 1;
+}
+
+uint8_t TA6932_FadeBusy(void){ return s_active; }
+uint8_t TA6932_FadeNeedsTick(void){ return (uint8_t)(s_active || fade_dithering()); }
+
+void TA6932_FadeTask(void){
+  uint32_t now = HAL_GetTick();
+  if (s_active){
+    uint32_t el = now - s_t0;
+    if (el >= s_dur){
+      TA6932_FadeCallback cb = s_cb;
+      s_active = 0;
+      s_cb = 0;
+      if (s_level != s_to) fade_setLevel(s_to);
+      fade_frame();
+      s_lastFrame = now;
+      if (cb) cb();
+      return;
+    }
+    int32_t span = (int32_t)s_to - (int32_t)s_from;
+    uint8_t lv = (uint8_t)((int32_t)s_from + span * (int32_t)el / (int32_t)s_dur);
+    if (lv != s_level) fade_setLevel(lv);
+  }
+  // إطار dithering فقط أثناء الـ fade (أو السكون مع TA6932_FADE_DITHER_STEADY) وبين درجتين
+  if (fade_dithering() && (now - s_lastFrame) >= TA6932_FADE_FRAME_MS){
+    s_lastFrame = now;
+    fade_frame();
+  }
+}
@@ -0,0 +1,88 @@
+// TA6932 field layout engine
+// Version: 1.0
+//Date:19/10/2026
+// - كل حقل يعلن خاناته ومصدره ودورة تحديثه
+// - المصدر يُسأل فقط عند استحقاق دورته، والرسم فقط إذا تغيّرت القيمة
+// - تُرسل خانات الحقول التي تغيّرت فقط (TA6932_WriteDirty): التاريخ يُرسم مرة في اليوم لا كل ثانية
+
+#include "ta6932_field.h"
+
+typedef struct {
+  TA6932_Field f;
+  uint32_t     value;   // آخر قيمة رُسمت
+  uint32_t     due;     // HAL tick للسؤال القادم
+  uint8_t      valid;   // 0 → ارسم عند السؤال القادم
+} TA_FieldSlot;
+
+static TA_FieldSlot s_fields[TA6932_FIELD_MAX];
+static uint8_t      s_count = 0;
+
+int8_t TA6932_FieldAdd(const TA6932_Field *f){
+  if (!f || !f->source || !f->count || f->first + f->count > 16) return -1;
+  if (!f->render && f->count > 8) return -1;          // الراسم الافتراضي: 8 أرقام BCD في uint32_t
+  if (s_count >= TA6932_FIELD_MAX) return -1;
+  TA_FieldSlot *s = &s_fields[s_count];
+  s->f = *f;
+  if (!s->f.render) s->f.render = TA6932_FieldRenderBCD;
+  s->due = HAL_GetTick();
+  s->valid = 0;
+  return (int8_t)s_count++;
+}
+
+void TA6932_FieldClear(void){ s_count = 0; }
+
+void TA6932_FieldInvalidate(int8_t id){
+  for (uint8_t i = 0; i < s_count; i++){
+    if (id >= 0 && i != (uint8_t)id) continue;
+    s_fields[i].valid = 0;
+    s_fields[i].due = HAL_GetTick();
+  }
+}
+
+uint16_t TA6932_FieldTask(void){
+  uint32_t now = HAL_GetTick();
+  uint16_t dirty = 0;
+  for (uint8_t i = 0; i < s_count; i++){
+    TA_FieldSlot *s = &s_fields[i];
+    if ((int32_t)(now - s->due) < 0) continue;       // لم يحن دوره
+    s->due = now + s->f.period_ms;
+    uint32_t v = s->f.source();
+    if (s->valid && v == s->value) continue;          // المصدر لم يتغير: لا رسم ولا إرسال
+    s->value = v;
+    s->valid = 1;
+    s->f.render(s->f.first, s->f.count, v);
+    dirty |= (uint16_t)(((1u << s->f.count) - 1u) << s->f.first);
+  }
+  TA6932_WriteDirty(dirty);
+  return dirty;
+}
+
+uint32_t TA6932_FieldNextDueMs(void){
+  uint32_t now = HAL_GetTick(), best = 0xFFFFFFFFu;
+  for (uint8_t i = 0; i < s_count; i++){
+    int32_t left = (int32_t)(s_fields[i].due - now);
+    uint32_t ms = (left > 0) ? (uint32_t)left : 0u;
+    if (ms < best) best = ms;
+  }
+  return best;
+}
+
+// dp الخانات يبقى كما هو (مثل TA6932_RenderClockBCD): النقطتان/الفواصل يرسمها التطبيق مرة واحدة
+void TA6932_FieldRenderBCD(uint8_t first, uint8_t count, uint32_t value){
+  uint8_t *buf = (uint8_t *)TA6932_LayerWords(TA6932_LAYER_BASE);
+  uint8_t a = (uint8_t)(first + count);               // من آخر خانة إلى الأولى
+  uint8_t d0, d1;
+  if (count > 8) count = 8;
+  while (count >= 2){
+    a -= 2; count -= 2;
+    d0 = buf[a & 0x0F] & 0x80; d1 = buf[(a + 1) & 0x0F] & 0x80;
+    TA6932_putBCD(a, (uint8_t)value, 0);
+    buf[a & 0x0F] |= d0; buf[(a + 1) & 0x0F] |= d1;
+    value >>= 8;
+  }
+  if (count){
+    a--;
+    d0 = buf[a & 0x0F] & 0x80;
+    TA6932_putDigit(a, (int)(value & 0x0F), d0);
+  }
+}
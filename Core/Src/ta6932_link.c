@@ -0,0 +1,117 @@
+// TA6932 SPI link rate
+//Version:1.0
+//Date:19/10/2026
+// - المعدل الفعلي يطبّقه clk_gov (قاسم SPI1 يُعاد حسابه عند كل تغيير لـ SYSCLK)
+// - الحفظ: سجلات 64-بت متتالية في صفحة PERSIST؛ آخر سجل صالح هو الحالي
+
+#include "ta6932_link.h"
+#include "clk_gov.h"
+#include "prof.h"
+
+#define LINK_MAGIC   0x544C4B31UL   // "TLK1"
+
+extern uint8_t _spersist[], _epersist[];   // من سكربت الربط
+
+// ===== Persist =====
+static const volatile uint64_t *link_slot(uint32_t i){
+  return (const volatile uint64_t *)(_spersist + i * 8u);
+}
+static uint32_t link_slots(void){
+  return (uint32_t)(_epersist - _spersist) / 8u;
+}
+
+uint32_t TA6932_LinkLoad(void){
+  uint32_t hz = 0;
+  for (uint32_t i = 0; i < link_slots(); i++){
+    uint64_t v = *link_slot(i);
+    if (v == 0xFFFFFFFFFFFFFFFFULL) break;           // أول خانة فارغة
+    if ((uint32_t)v == LINK_MAGIC) hz = (uint32_t)(v >> 32);
+  }
+  if (hz) ClkGov_SetSpiRate(hz);
+  return hz;
+}
+
+HAL_StatusTypeDef TA6932_LinkSave(uint32_t hz){
+  HAL_StatusTypeDef st;
+  uint32_t i, n = link_slots();
+  uint32_t cur = 0;
+
+  for (i = 0; i < n; i++){
+    uint64_t v = *link_slot(i);
+    if (v == 0xFFFFFFFFFFFFFFFFULL) break;
+    if ((uint32_t)v == LINK_MAGIC) cur = (uint32_t)(v >> 32);
+  }
+  if (cur == hz) return HAL_OK;                      // لا كتابة بلا تغيير
+
+  HAL_FLASH_Unlock();
+  if (i == n){                                       // الصفحة ممتلئة → مسح
+    FLASH_EraseInitTypeDef e;
+    uint32_t err = 0;
+    e.TypeErase = FLASH_TYPEERASE_PAGES;
+    e.Page      = ((uint32_t)_spersist - FLASH_BASE) / FLASH_PAGE_SIZE;
+    e.NbPages   = 1;
+    st = HAL_FLASHEx_Erase(&e, &err);
+    if (st != HAL_OK){ HAL_FLASH_Lock(); return st; }
+    i = 0;
+  }
+  st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, (uint32_t)_spersist + i * 8u,
+                         ((uint64_t)hz << 32) | LINK_MAGIC);
+  HAL_FLASH_Lock();
+  return st;
+}
+
+// ===== Rate =====
+void TA6932_SetLinkRate(uint32_t hz){
+  ClkGov_SetSpiRate(hz);
+}
+
+// إطار اختبار r: آحاد متنقلة + 0x55/0xAA متناوبة (كل خطوط البيانات في الحالتين)
+static void link_pattern(uint8_t r, uint8_t *f){
+  for (uint8_t i = 0; i < 16; i++)
+    f[i] = (i & 1) ? (uint8_t)((r & 1) ? 0xAA : 0x55) : (uint8_t)(1u << ((i + r) & 7));
+}
+
+uint32_t TA6932_LinkSweep(TA6932_LinkCheck check, TA6932_LinkStep *steps, uint8_t *count){
+  uint32_t best = 0;
+  uint8_t  n = 0;
+  uint8_t  f[16];
+
+  if (count) *count = 0;
+  if (!check) return 0;                         // بلا تحقق فعلي لا يوجد ما يُقاس أو يُحفظ
+  if (ClkGov_Boost() != HAL_OK) return 0;       // المعدلات والدورات محسوبة على 48MHz
+
+  for (uint32_t hz = TA6932_LINK_SWEEP_MIN_HZ; hz <= TA6932_LINK_SWEEP_MAX_HZ && n < TA6932_LINK_MAX_STEPS; hz <<= 1){
+    uint8_t  ok = TA6932_CheckStbTiming(hz, SystemCoreClock, NULL);  // حدود STB دائماً
+    uint32_t cyc = 0;
+
+    if (ok){
+      ClkGov_SetSpiRate(hz);
+      for (uint8_t r = 0; r < TA6932_LINK_REPEAT && ok; r++){
+        uint32_t t0;
+        link_pattern(r, f);
+        TA6932_loadBuffer(f);
+        t0 = PROF_Stamp();
+        TA6932_WriteAll();
+        cyc += PROF_Cycles(t0);
+        if (!check(f)) ok = 0;
+      }
+    }
+    if (steps){
+      steps[n].hz          = ok ? ClkGov_SpiRate() : hz;
+      steps[n].ok          = ok;
+      steps[n].frameCycles = ok ? cyc / TA6932_LINK_REPEAT : 0;
+    }
+    n++;
+    if (!ok) break;       // الأسرع لن ينجح إذا فشل هذا
+    best = hz;
+  }
+  if (count) *count = n;
+
+  if (best){
+    ClkGov_SetSpiRate(best);
+    (void)TA6932_LinkSave(best);
+  } else {
+    if (!TA6932_LinkLoad()) ClkGov_SetSpiRate(CLKGOV_SPI_HZ);  // لا شيء نجح: أعد المعدل السابق
+  }
+  return best;
+}
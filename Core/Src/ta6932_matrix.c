@@ -0,0 +1,97 @@
+// TA6932 matrix mode (16x8 LED matrix / bar-graph)
+// Version: 1.0
+//Date:19/10/2026
+// - التطبيق يرسم في صورة نقطية صفّية: 16 عموداً (الخانات) × 8 صفوف (خطوط المقاطع)
+// - عند الإرسال تُقلب كل بلاطة 8x8 بثلاث عمليات delta-swap على كلمتين 32-بت،
+//   فتخرج مباشرة بترتيب الخانات (كلمة = 4 خانات) في طبقة BASE
+
+#include "ta6932_matrix.h"
+#include "prof.h"
+
+// البلاطة t (الأعمدة 8t..8t+7): البايت 8t+y = الصف y، bit (x&7)؛ الكلمتان 2t و2t+1
+static uint32_t s_bmp[4];
+#define TA_BMP    ((uint8_t *)s_bmp)
+#define TA_MX_AT(x, y)  TA_BMP[(((x) >> 3) << 3) + (y)]
+
+void TA6932_MatrixClear(void){
+  s_bmp[0] = 0; s_bmp[1] = 0; s_bmp[2] = 0; s_bmp[3] = 0;
+}
+
+void TA6932_MatrixPixel(uint8_t x, uint8_t y, uint8_t on){
+  if (x >= TA6932_MATRIX_W || y >= TA6932_MATRIX_H) return;
+  uint8_t bit = (uint8_t)(1u << (x & 7));
+  if (on) TA_MX_AT(x, y) |= bit; else TA_MX_AT(x, y) &= (uint8_t)~bit;
+}
+
+uint8_t TA6932_MatrixGetPixel(uint8_t x, uint8_t y){
+  if (x >= TA6932_MATRIX_W || y >= TA6932_MATRIX_H) return 0;
+  return (uint8_t)((TA_MX_AT(x, y) >> (x & 7)) & 1u);
+}
+
+// صف: قناع بايت لكل بلاطة بدل نقطة نقطة
+void TA6932_MatrixHLine(uint8_t x0, uint8_t x1, uint8_t y, uint8_t on){
+  if (x0 > x1){ uint8_t t = x0; x0 = x1; x1 = t; }
+  if (y >= TA6932_MATRIX_H || x0 >= TA6932_MATRIX_W) return;
+  if (x1 >= TA6932_MATRIX_W) x1 = TA6932_MATRIX_W - 1;
+  uint16_t m = (uint16_t)(((2u << x1) - 1u) & ~((1u << x0) - 1u));
+  for (uint8_t t = 0; t < 2; t++){
+    uint8_t b = (uint8_t)(m >> (8 * t));
+    if (!b) continue;
+    if (on) TA_BMP[8 * t + y] |= b; else TA_BMP[8 * t + y] &= (uint8_t)~b;
+  }
+}
+
+void TA6932_MatrixVLine(uint8_t x, uint8_t y0, uint8_t y1, uint8_t on){
+  if (y0 > y1){ uint8_t t = y0; y0 = y1; y1 = t; }
+  for (uint8_t y = y0; y <= y1 && y < TA6932_MATRIX_H; y++) TA6932_MatrixPixel(x, y, on);
+}
+
+void TA6932_MatrixLine(int8_t x0, int8_t y0, int8_t x1, int8_t y1, uint8_t on){
+  int8_t dx = (int8_t)(x1 > x0 ? x1 - x0 : x0 - x1), sx = (int8_t)(x0 < x1 ? 1 : -1);
+  int8_t dy = (int8_t)(y1 > y0 ? y0 - y1 : y1 - y0), sy = (int8_t)(y0 < y1 ? 1 : -1);
+  int16_t err = dx + dy;
+  for (;;){
+    if (x0 >= 0 && y0 >= 0) TA6932_MatrixPixel((uint8_t)x0, (uint8_t)y0, on);
+    if (x0 == x1 && y0 == y1) break;
+    int16_t e2 = (int16_t)(2 * err);
+    if (e2 >= dy){ err += dy; x0 = (int8_t)(x0 + sx); }
+    if (e2 <= dx){ err += dx; y0 = (int8_t)(y0 + sy); }
+  }
+}
+
+void TA6932_MatrixColumn(uint8_t x, uint8_t bits){
+  for (uint8_t y = 0; y < TA6932_MATRIX_H; y++) TA6932_MatrixPixel(x, y, (uint8_t)((bits >> y) & 1u));
+}
+
+void TA6932_MatrixBar(uint8_t x, uint8_t height){
+  if (height > TA6932_MATRIX_H) height = TA6932_MATRIX_H;
+  TA6932_MatrixColumn(x, (uint8_t)(0xFF00u >> height));   // الصفوف 8-h..7
+}
+
+// ===== SWAR 8x8 bit transpose =====
+// x = الصفوف 0..3 (بايت لكل صف)، y = الصفوف 4..7. بعد القلب: بايت i من x = العمود i، من y = العمود 4+i.
+// ثلاث مبادلات كتل: 4x4 بين الكلمتين، ثم 2x2 (إزاحة 14) ثم 1x1 (إزاحة 7) داخل كل كلمة.
+static TA_RAMFUNC void TA_mxTranspose(const uint32_t *src, uint32_t *dst){
+  for (uint8_t t = 0; t < 4; t += 2){
+    uint32_t x = src[t], y = src[t + 1], d;
+    d = ((x >> 4) ^ y) & 0x0F0F0F0Fu;  y ^= d;  x ^= d << 4;
+    d = (x ^ (x >> 14)) & 0x0000CCCCu; x ^= d ^ (d << 14);
+    d = (y ^ (y >> 14)) & 0x0000CCCCu; y ^= d ^ (d << 14);
+    d = (x ^ (x >> 7)) & 0x00AA00AAu;  x ^= d ^ (d << 7);
+    d = (y ^ (y >> 7)) & 0x00AA00AAu;  y ^= d ^ (d << 7);
+    dst[t] = x; dst[t + 1] = y;
+  }
+}
+
+void TA6932_MatrixFlush(void){
+  TA_mxTranspose(s_bmp, TA6932_LayerWords(TA6932_LAYER_BASE));
+  TA6932_WriteAll();
+}
+
+uint32_t TA6932_BenchMatrix(uint16_t n){
+  uint32_t *base = TA6932_LayerWords(TA6932_LAYER_BASE);
+  if (n == 0) return 0;
+  uint32_t t0 = PROF_Stamp();
+  for (uint16_t i = 0; i < n; i++) TA_mxTranspose(s_bmp, base);
+  return PROF_Cycles(t0) / n;
+}
@@ -51,42 +51,103 @@ defined in linker script */
 Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
+/* Free-running SysTick from the first instructions: main() reads the
+   reset-to-main cycle count (BOOT_CaptureReset) before HAL_Init() reloads it */
+  ldr   r0, =0xE000E010 /* SysTick->CTRL */
+  ldr   r1, =0x00FFFFFF
+  str   r1, [r0, #4]    /* LOAD */
+  str   r1, [r0, #8]    /* VAL (any write clears it) */
+  movs  r1, #5          /* CLKSOURCE = processor clock, ENABLE */
+  str   r1, [r0]
 /* Call the clock system initialization function.*/
   bl  SystemInit
 
-/* Copy the data segment initializers from flash to SRAM */
-  movs r1, #0
-  b LoopCopyDataInit
-
-CopyDataInit:
-  ldr r3, =_sidata
-  ldr r3, [r3, r1]
-  str r3, [r0, r1]
-  adds r1, r1, #4
-
-LoopCopyDataInit:
+/* Copy the data segment initializers from flash to SRAM,
+   four words per LDM/STM pair, then the remaining 0..3 words */
   ldr r0, =_sdata
-  ldr r3, =_edata
-  adds r2, r0, r1
-  cmp r2, r3
-  bcc CopyDataInit
-  ldr r2, =_sbss
-  b LoopFillZerobss
-/* Zero fill the bss segment. */
-FillZerobss:
-  movs r3, #0
-  str  r3, [r2]
-  adds r2, r2, #4
-
-
-LoopFillZerobss:
-  ldr r3, = _ebss
-  cmp r2, r3
-  bcc FillZerobss
-
-
-/* Call static constructors */
+  ldr r1, =_sidata
+  ldr r2, =_edata
+  subs r2, r2, r0
+  b LoopCopyData4
+
+CopyData4:
+  ldmia r1!, {r4-r7}
+  stmia r0!, {r4-r7}
+
+LoopCopyData4:
+  subs r2, r2, #16
+  bhs CopyData4
+  adds r2, r2, #16
+  b LoopCopyData1
+
+CopyData1:
+  ldmia r1!, {r4}
+  stmia r0!, {r4}
+
+LoopCopyData1:
+  subs r2, r2, #4
+  bhs CopyData1
+
+/* Zero fill the bss segment, same scheme */
+  ldr r0, =_sbss
+  ldr r2, =_ebss
+  subs r2, r2, r0
+  movs r4, #0
+  movs r5, #0
+  movs r6, #0
+  movs r7, #0
+  b LoopFillZero4
+
+FillZero4:
+  stmia r0!, {r4-r7}
+
+LoopFillZero4:
+  subs r2, r2, #16
+  bhs FillZero4
+  adds r2, r2, #16
+  b LoopFillZero1
+
+FillZero1:
+  stmia r0!, {r4}
+
+LoopFillZero1:
+  subs r2, r2, #4
+  bhs FillZero1
+
+/* Optional vector table in SRAM (_vector_in_ram in the linker script):
+   the .ram_vector area is empty unless it is enabled */
+  ldr r0, =_sram_vector
+  ldr r2, =_eram_vector
+  subs r2, r2, r0
+  beq SkipVectorCopy
+  ldr r3, =0xE000ED08   /* SCB->VTOR */
+  str r0, [r3]          /* written before the copy, no interrupt is enabled yet */
+  ldr r1, =g_pfnVectors
+
+CopyVector:
+  ldmia r1!, {r4-r7}
+  stmia r0!, {r4-r7}
+  subs r2, r2, #16
+  bhi CopyVector
+  dsb
+
+SkipVectorCopy:
+
+/* Call static constructors, only when there are any
+   (__libc_init_array would otherwise just walk two empty tables) */
+  ldr r0, =__preinit_array_start
+  ldr r1, =__preinit_array_end
+  cmp r0, r1
+  bne CallInitArray
+  ldr r0, =__init_array_start
+  ldr r1, =__init_array_end
+  cmp r0, r1
+  beq SkipInitArray
+
+CallInitArray:
   bl __libc_init_array
+
+SkipInitArray:
 /* Call the application's entry point.*/
   bl main
 
@@ -0,0 +1,128 @@
+/*
+ * test_ds3231_cal.c  (host)
+ *
+ * Runs ds3231_cal.c against a host RTC model with injected drift:
+ * - RtcCal_DriftPpb / RtcCal_NextAging sign, rounding and clamping
+ * - one measurement window through RtcCal_Port, then a second window with the
+ *   new aging value: the drift left must match RtcCal_ResidualPpb()
+ * - RtcCal_ClockNow across many refNow wraps
+ * Build and run: make -C Tests/host
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ds3231_cal.h"
+
+static unsigned s_fail = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)){ if (s_fail++ < 10){ printf(__VA_ARGS__); putchar('\n'); } } } while (0)
+
+/* The default port functions are only referenced, never called here */
+HAL_StatusTypeDef DS3231_ReadAging(int8_t *aging){ (void)aging; return HAL_ERROR; }
+HAL_StatusTypeDef DS3231_WriteAging(int8_t aging){ (void)aging; return HAL_ERROR; }
+HAL_StatusTypeDef DS3231_StartConversion(void){ return HAL_ERROR; }
+HAL_StatusTypeDef DS3231_ReadTemperatureCenti(int16_t *centi){ (void)centi; return HAL_ERROR; }
+HAL_StatusTypeDef DS3231_Enable1HzSQW(void){ return HAL_ERROR; }
+
+/* ===== RTC model =====
+ * One RTC second lasts (1 + drift) reference seconds, drift = injected + aging * 0.1 ppm
+ * (a higher aging value slows the oscillator).
+ */
+static uint64_t m_ref;          // reference ticks (refNow returns the low 32 bits)
+static int32_t  m_injPpb;
+static int8_t   m_aging;
+static uint32_t m_writes;
+
+static uint32_t m_refNow(void){ return (uint32_t)m_ref; }
+static HAL_StatusTypeDef m_readAging(int8_t *a){ *a = m_aging; return HAL_OK; }
+static HAL_StatusTypeDef m_writeAging(int8_t a){ m_aging = a; m_writes++; return HAL_OK; }
+static HAL_StatusTypeDef m_readTemp(int16_t *c){ *c = 2500; return HAL_OK; }
+static HAL_StatusTypeDef m_sqw(void){ return HAL_OK; }
+
+#define REF_HZ  1000000UL
+
+/* Runs one window of window_s seconds; returns the drift the service measured */
+static int32_t model_window(uint16_t window_s){
+    int64_t drift = m_injPpb + (int64_t)m_aging * RTCCAL_PPB_PER_LSB;
+    uint64_t base = m_ref;
+    CHECK(RtcCal_Start(window_s) == HAL_OK, "RtcCal_Start");
+    for (uint32_t n = 0; n <= window_s; n++){
+        m_ref = base + (uint64_t)((int64_t)n * (int64_t)REF_HZ + (int64_t)n * (int64_t)REF_HZ * drift / 1000000000LL);
+        RtcCal_OnSqwEdge();
+    }
+    CHECK(!RtcCal_Active(), "window still open after %u edges", window_s + 1);
+    CHECK(RtcCal_Task() == 1, "RtcCal_Task did not report the window");
+    return RtcCal_LastDriftPpb();
+}
+
+static void test_pure(void){
+    /* +1.5 ppm over 1000 s at 1 MHz = 1500 extra ticks */
+    CHECK(RtcCal_DriftPpb(1000000000ULL + 1500, 1000, REF_HZ) == 1500, "DriftPpb +");
+    CHECK(RtcCal_DriftPpb(1000000000ULL - 1500, 1000, REF_HZ) == -1500, "DriftPpb -");
+    CHECK(RtcCal_DriftPpb(123, 0, REF_HZ) == 0, "DriftPpb 0 s");
+
+    /* RTC slow (+) => lower aging; nearest LSB, halves away from zero */
+    CHECK(RtcCal_NextAging(0, 2000) == -20, "NextAging +2000");
+    CHECK(RtcCal_NextAging(0, -2000) == 20, "NextAging -2000");
+    CHECK(RtcCal_NextAging(0, 149) == -1 && RtcCal_NextAging(0, 150) == -2, "NextAging round +");
+    CHECK(RtcCal_NextAging(0, -149) == 1 && RtcCal_NextAging(0, -150) == 2, "NextAging round -");
+    CHECK(RtcCal_NextAging(0, 49) == 0 && RtcCal_NextAging(0, -49) == 0, "NextAging dead band");
+    CHECK(RtcCal_NextAging(-120, 2000) == -128, "NextAging clamp low");
+    CHECK(RtcCal_NextAging(120, -2000) == 127, "NextAging clamp high");
+}
+
+static void test_window(int32_t inj_ppb){
+    static const RtcCal_Port port = { m_refNow, REF_HZ, m_readAging, m_writeAging, m_readTemp, m_sqw };
+    RtcCal_LogEntry log[RTCCAL_LOG_SIZE];
+    uint8_t n;
+    m_ref = 0xFFFF0000u;            // refNow wraps inside the first window
+    m_injPpb = inj_ppb;
+    m_aging = 0;
+    m_writes = 0;
+    RtcCal_Init(&port);
+
+    int32_t d1 = model_window(600);
+    CHECK(abs(d1 - inj_ppb) <= 2, "inj %ld: measured %ld", (long)inj_ppb, (long)d1);
+    CHECK(m_aging == RtcCal_NextAging(0, d1) && m_writes == (m_aging != 0), "inj %ld: aging %d", (long)inj_ppb, m_aging);
+
+    /* What the correction leaves, as predicted and as measured by a second window */
+    int32_t res = RtcCal_ResidualPpb();
+    CHECK(abs(res) <= RTCCAL_PPB_PER_LSB / 2 + 2, "inj %ld: residual %ld", (long)inj_ppb, (long)res);
+    int32_t d2 = model_window(600);
+    CHECK(abs(d2 - res) <= 2, "inj %ld: second window %ld, residual %ld", (long)inj_ppb, (long)d2, (long)res);
+
+    n = RtcCal_GetLog(log, RTCCAL_LOG_SIZE);       // the log outlives RtcCal_Init: last two entries
+    CHECK(n >= 2 && log[n - 2].drift_ppb == d1 && log[n - 1].drift_ppb == d2
+          && log[n - 2].aging == 0 && log[n - 1].aging == m_aging && log[n - 2].temp_centi == 2500,
+          "inj %ld: log", (long)inj_ppb);
+}
+
+static void test_clock(void){
+    static const RtcCal_Port port = { m_refNow, 48000000UL, m_readAging, m_writeAging, m_readTemp, m_sqw };
+    RtcCal_Init(&port);
+    m_ref = 0xFFFFFF00u;
+    RtcCal_ClockSync(1000);
+    CHECK(RtcCal_ClockNow() == 1000, "ClockNow at sync");
+
+    /* 24 h in 50 s steps (2.4e9 ticks, below the ~89 s wrap period): 971 wraps */
+    for (uint32_t t = 50; t <= 86400; t += 50){
+        m_ref += 50ULL * 48000000ULL;
+        (void)RtcCal_Task();
+    }
+    CHECK(RtcCal_ClockNow() == 1000 + 86400, "ClockNow after 24 h: %lu", (unsigned long)RtcCal_ClockNow());
+
+    m_ref += 48000000ULL - 1;       // one tick short of the next second
+    CHECK(RtcCal_ClockNow() == 1000 + 86400, "ClockNow partial second");
+    m_ref += 1;
+    CHECK(RtcCal_ClockNow() == 1000 + 86401, "ClockNow next second");
+}
+
+int main(void){
+    test_pure();
+    test_window(2030);
+    test_window(-3470);
+    test_window(0);
+    test_clock();
+    printf("ds3231_cal: %u failures\n", s_fail);
+    return s_fail != 0;
+}
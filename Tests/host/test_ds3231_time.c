@@ -0,0 +1,59 @@
+/*
+ * test_ds3231_time.c  (host)
+ *
+ * Checks ds3231_time.c against the C library (timegm/gmtime) for every day
+ * of 2000-01-01 .. 2099-12-31, plus the invalid-register guards.
+ * Build and run: make -C Tests/host
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <time.h>
+#include "ds3231_time.h"
+
+static unsigned s_fail = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)){ if (s_fail++ < 10){ printf(__VA_ARGS__); putchar('\n'); } } } while (0)
+
+int main(void){
+    unsigned days = 0;
+    for (time_t e = DS3231_EPOCH_2000; ; e += 86400 + 1, days++){
+        struct tm g;
+        gmtime_r(&e, &g);
+        if (g.tm_year + 1900 > 2099) break;
+
+        DS3231_TimeTypeDef t;
+        DS3231_FromEpoch((uint32_t)e, &t);
+        CHECK(t.year == g.tm_year + 1900 && t.month == g.tm_mon + 1 && t.date == g.tm_mday,
+              "FromEpoch %ld: %u-%u-%u", (long)e, t.year, t.month, t.date);
+        CHECK(t.hours == g.tm_hour && t.minutes == g.tm_min && t.seconds == g.tm_sec,
+              "FromEpoch %ld: %u:%u:%u", (long)e, t.hours, t.minutes, t.seconds);
+        CHECK(t.day == g.tm_wday + 1, "weekday %ld: %u", (long)e, t.day);
+        CHECK(DS3231_ToEpoch(&t) == (uint32_t)e, "ToEpoch %ld", (long)e);
+        CHECK(DS3231_DayOfWeek(t.year, t.month, t.date) == t.day, "DayOfWeek %ld", (long)e);
+
+        struct tm n = g;                       // last day of this month via timegm
+        n.tm_mon++; n.tm_mday = 0;
+        time_t last = timegm(&n);
+        gmtime_r(&last, &n);
+        CHECK(DS3231_DaysInMonth(t.year, t.month) == n.tm_mday, "DaysInMonth %u-%u", t.year, t.month);
+    }
+
+    /* AddSeconds / DiffSeconds across a leap day */
+    DS3231_TimeTypeDef a = { 59, 59, 23, 0, 28, 2, 2024 }, b = a;
+    DS3231_AddSeconds(&b, 86401);
+    CHECK(b.month == 3 && b.date == 1 && b.hours == 0 && b.minutes == 0 && b.seconds == 0,
+          "AddSeconds leap: %u-%u %u:%u:%u", b.month, b.date, b.hours, b.minutes, b.seconds);
+    CHECK(DS3231_DiffSeconds(&b, &a) == 86401, "DiffSeconds");
+    DS3231_AddSeconds(&b, -86401);
+    CHECK(DS3231_DiffSeconds(&b, &a) == 0, "AddSeconds negative");
+
+    /* Corrupt registers must not index past the month table */
+    CHECK(DS3231_DaysSince2000(2024, 0, 1) == 0, "month 0");
+    CHECK(DS3231_DaysSince2000(2024, 13, 1) == 0, "month 13");
+    CHECK(DS3231_DaysSince2000(2024, 1, 0) == 0, "date 0");
+    CHECK(DS3231_DaysInMonth(2024, 0) == 0 && DS3231_DaysInMonth(2024, 13) == 0, "DaysInMonth range");
+
+    printf("ds3231_time: %u days checked, %u failures\n", days, s_fail);
+    return s_fail != 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+# size_compare.sh  - per-object flash comparison of two GNU ld map files
+#
+#   Tools/size_compare.sh Debug/TA6932_Test.map Release/TA6932_Test.map
+#
+# Sums the linked .text/.rodata/.data input sections of each object (the
+# "Discarded input sections" block is skipped) and prints both columns and
+# the difference, largest objects first. Run arm-none-eabi-size on the two
+# .elf files for the section totals. With -flto the after-map attributes code to
+# ltrans objects, so compare the TOTAL line (and ta6932/HAL where still named).
+
+[ $# -eq 2 ] || { echo "usage: $0 before.map after.map" >&2; exit 1; }
+
+sum_map() {
+    awk '
+    function hex(h,   i, v) {                      # portable (no gawk strtonum)
+        v = 0; h = tolower(substr(h, 3))
+        for (i = 1; i <= length(h); i++) v = v * 16 + index("0123456789abcdef", substr(h, i, 1)) - 1
+        return v
+    }
+    /^Linker script and memory map/ { on = 1 }
+    !on { next }
+    /^ \.(text|rodata|data|RamFunc)/ {
+        if (NF >= 4) { sz = $3; obj = $4 }
+        else { pend = 1; next }
+    }
+    pend && /^ +0x/ { sz = $2; obj = $3; pend = 0 }
+    sz != "" {
+        n = split(obj, p, "/"); o = p[n]; sub(/\(.*/, "", o)
+        if (obj ~ /\.a\(/) { split(obj, q, "("); o = q[2]; sub(/\)$/, "", o) }
+        s[o] += hex(sz); sz = ""
+    }
+    END { for (o in s) if (s[o]) print o, s[o] }' "$1"
+}
+
+sum_map "$1" | sort > /tmp/size_a.$$
+sum_map "$2" | sort > /tmp/size_b.$$
+join -a1 -a2 -e0 -o 0,1.2,2.2 /tmp/size_a.$$ /tmp/size_b.$$ |
+    awk '{ d = $3 - $2; ta += $2; tb += $3; printf "%-32s %7d %7d %+7d\n", $1, $2, $3, d }
+         END { printf "%-32s %7d %7d %+7d\n", "TOTAL", ta, tb, tb - ta }' |
+    sort -k2,2nr
+rm -f /tmp/size_a.$$ /tmp/size_b.$$